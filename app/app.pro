@@ -20,21 +20,31 @@ HEADERS += \
     src/base/comment.h \
     src/base/concurrenttransfersmodel.h \
     src/base/database.h \
+    src/base/filewriter.h \
     src/base/json.h \
+    src/base/jsonparser.h \
     src/base/localemodel.h \
+    src/base/networkaccessmanager.h \
     src/base/networkproxytypemodel.h \
     src/base/playlist.h \
+    src/base/postprocessor.h \
+    src/base/ratelimiter.h \
     src/base/resources.h \
+    src/base/responsecache.h \
+    src/base/rolelistmodel.h \
+    src/base/roletable.h \
     src/base/searchhistorymodel.h \
     src/base/selectionmodel.h \
     src/base/servicemodel.h \
     src/base/settings.h \
+    src/base/streamcache.h \
     src/base/transfer.h \
     src/base/transfers.h \
     src/base/user.h \
     src/base/utils.h \
     src/base/video.h \
     src/base/videomodel.h \
+    src/base/videoregistry.h \
     src/base/videolauncher.h \
     src/base/videoplayermodel.h \
     src/dailymotion/dailymotion.h \
@@ -62,6 +72,7 @@ HEADERS += \
     src/plugins/pluginsettingsmodel.h \
     src/plugins/resourcesplugins.h \
     src/plugins/resourcesrequest.h \
+    src/plugins/resourcesworker.h \
     src/plugins/pluginsearchtypemodel.h \
     src/plugins/pluginstreammodel.h \
     src/plugins/pluginsubtitlemodel.h \
@@ -108,12 +119,20 @@ SOURCES += \
     src/base/categorymodel.cpp \
     src/base/clipboard.cpp \
     src/base/comment.cpp \
+    src/base/filewriter.cpp \
     src/base/json.cpp \
+    src/base/jsonparser.cpp \
+    src/base/networkaccessmanager.cpp \
     src/base/playlist.cpp \
+    src/base/postprocessor.cpp \
+    src/base/ratelimiter.cpp \
     src/base/resources.cpp \
+    src/base/responsecache.cpp \
+    src/base/rolelistmodel.cpp \
     src/base/searchhistorymodel.cpp \
     src/base/selectionmodel.cpp \
     src/base/settings.cpp \
+    src/base/streamcache.cpp \
     src/base/transfer.cpp \
     src/base/transfers.cpp \
     src/base/user.cpp \
@@ -143,6 +162,7 @@ SOURCES += \
     src/plugins/pluginplaylistmodel.cpp \
     src/plugins/resourcesplugins.cpp \
     src/plugins/resourcesrequest.cpp \
+    src/plugins/resourcesworker.cpp \
     src/plugins/pluginstreammodel.cpp \
     src/plugins/pluginsubtitlemodel.cpp \
     src/plugins/plugintransfer.cpp \
@@ -631,8 +651,13 @@ unix:!symbian {
     
     INCLUDEPATH += src/dbus
     
-    HEADERS += src/dbus/dbusservice.h
-    SOURCES += src/dbus/dbusservice.cpp
+    HEADERS += \
+        src/dbus/daemon.h \
+        src/dbus/dbusservice.h
+    
+    SOURCES += \
+        src/dbus/daemon.cpp \
+        src/dbus/dbusservice.cpp
     
     dbus_service.files = dbus/org.marxoft.cutetube2.service
     dbus_service.path = /usr/share/dbus-1/services
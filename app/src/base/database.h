@@ -56,6 +56,15 @@ inline void initDatabase() {
     if (query.lastError().isValid()) {
         qDebug() << "initDatabase: database error:" << query.lastError().text();
     }
+    
+    query = db.exec("CREATE TABLE IF NOT EXISTS transfers (id TEXT PRIMARY KEY, position INTEGER, service TEXT, \
+    resourceId TEXT, streamId TEXT, streamUrl TEXT, title TEXT, category TEXT, downloadPath TEXT, fileName TEXT, \
+    priority INTEGER, size INTEGER, convertToAudio INTEGER, downloadSubtitles INTEGER, subtitlesLanguage TEXT, \
+    segments TEXT)");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
 }
 
 inline QSqlDatabase getDatabase() {
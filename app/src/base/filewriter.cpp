@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "filewriter.h"
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+static const int WRITE_BUFFER_SIZE = 1024 * 256;
+static const int WRITE_BUFFER_COUNT = 4;
+
+FileWriter::FileWriter(QObject *parent) :
+    QThread(parent),
+    m_bufferSize(0),
+    m_bufferCount(0),
+    m_closing(false),
+    m_error(false)
+{
+}
+
+FileWriter::~FileWriter() {
+    close();
+}
+
+QString FileWriter::errorString() const {
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+bool FileWriter::isOpen() const {
+    return m_file.isOpen();
+}
+
+bool FileWriter::open(const QString &fileName, bool positioned) {
+    close();
+    m_file.setFileName(fileName);
+    const QIODevice::OpenMode mode = positioned ? QFile::ReadWrite : m_file.exists() ? QFile::Append : QFile::WriteOnly;
+    
+    if (!m_file.open(mode | QFile::Unbuffered)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    
+    if (m_buffer.isEmpty()) {
+        m_buffer.resize(WRITE_BUFFER_SIZE);
+        m_bufferCount++;
+    }
+    
+    m_bufferSize = 0;
+    m_closing = false;
+    m_error = false;
+    m_errorString = QString();
+    start();
+    return true;
+}
+
+bool FileWriter::preallocate(qint64 size) {
+    if ((!m_file.isOpen()) || (size <= 0)) {
+        return false;
+    }
+#if (defined Q_OS_LINUX) && (defined FALLOC_FL_KEEP_SIZE)
+    if (fallocate(m_file.handle(), FALLOC_FL_KEEP_SIZE, 0, size) == 0) {
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "FileWriter::preallocate" << m_file.fileName() << size;
+#endif
+        return true;
+    }
+#endif
+    return false;
+}
+
+qint64 FileWriter::read(QIODevice *device, qint64 maxSize) {
+    if (!m_file.isOpen()) {
+        return -1;
+    }
+    
+    m_mutex.lock();
+    const bool error = m_error;
+    m_mutex.unlock();
+    
+    if (error) {
+        return -1;
+    }
+    
+    qint64 total = 0;
+    
+    while (total < maxSize) {
+        const qint64 bytes = device->read(m_buffer.data() + m_bufferSize,
+                                          qMin(maxSize - total, qint64(m_buffer.size() - m_bufferSize)));
+        
+        if (bytes <= 0) {
+            break;
+        }
+        
+        m_bufferSize += bytes;
+        total += bytes;
+        
+        if (m_bufferSize == m_buffer.size()) {
+            flushBuffer();
+        }
+    }
+    
+    return total;
+}
+
+bool FileWriter::write(qint64 pos, const QByteArray &data) {
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    
+    while ((m_pending.size() >= WRITE_BUFFER_COUNT) && (!m_error)) {
+        m_freeCondition.wait(&m_mutex);
+    }
+    
+    if (m_error) {
+        return false;
+    }
+    
+    Chunk chunk;
+    chunk.data = data;
+    chunk.size = data.size();
+    chunk.pos = pos;
+    m_pending << chunk;
+    m_pendingCondition.wakeOne();
+    return true;
+}
+
+bool FileWriter::close() {
+    if (!m_file.isOpen()) {
+        return !m_error;
+    }
+    
+    flushBuffer();
+    m_mutex.lock();
+    m_closing = true;
+    m_pendingCondition.wakeOne();
+    m_mutex.unlock();
+    wait();
+    m_file.close();
+    return !m_error;
+}
+
+void FileWriter::flushBuffer() {
+    if (m_bufferSize == 0) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    Chunk chunk;
+    chunk.data = m_buffer;
+    chunk.size = m_bufferSize;
+    chunk.pos = -1;
+    m_pending << chunk;
+    chunk.data.clear();
+    m_buffer.clear();
+    m_bufferSize = 0;
+    m_pendingCondition.wakeOne();
+    
+    while ((m_free.isEmpty()) && (m_bufferCount >= WRITE_BUFFER_COUNT) && (!m_error)) {
+        m_freeCondition.wait(&m_mutex);
+    }
+    
+    if (!m_free.isEmpty()) {
+        m_buffer = m_free.takeFirst();
+    }
+    else {
+        m_buffer.resize(WRITE_BUFFER_SIZE);
+        m_bufferCount++;
+    }
+}
+
+void FileWriter::run() {
+    forever {
+        m_mutex.lock();
+        
+        while ((m_pending.isEmpty()) && (!m_closing)) {
+            m_pendingCondition.wait(&m_mutex);
+        }
+        
+        if (m_pending.isEmpty()) {
+            m_mutex.unlock();
+            return;
+        }
+        
+        Chunk chunk = m_pending.takeFirst();
+        const bool error = m_error;
+        m_mutex.unlock();
+        
+        const bool written = (!error) && ((chunk.pos < 0) || (m_file.seek(chunk.pos)))
+                             && (m_file.write(chunk.data.constData(), chunk.size) == chunk.size);
+        
+        m_mutex.lock();
+        
+        if ((!written) && (!m_error)) {
+            m_error = true;
+            m_errorString = m_file.errorString();
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "FileWriter::run: Write error" << m_file.fileName() << m_errorString;
+#endif
+        }
+        
+        if (chunk.pos < 0) {
+            m_free << chunk.data;
+        }
+        
+        chunk.data.clear();
+        m_freeCondition.wakeOne();
+        m_mutex.unlock();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILEWRITER_H
+#define FILEWRITER_H
+
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+class FileWriter : public QThread
+{
+    Q_OBJECT
+    
+public:
+    explicit FileWriter(QObject *parent = 0);
+    ~FileWriter();
+    
+    QString errorString() const;
+    
+    bool isOpen() const;
+    
+    bool open(const QString &fileName, bool positioned = false);
+    bool preallocate(qint64 size);
+    qint64 read(QIODevice *device, qint64 maxSize);
+    bool write(qint64 pos, const QByteArray &data);
+    bool close();
+    
+protected:
+    void run();
+    
+private:
+    void flushBuffer();
+    
+    struct Chunk {
+        QByteArray data;
+        int size;
+        qint64 pos;
+    };
+    
+    QFile m_file;
+    
+    mutable QMutex m_mutex;
+    QWaitCondition m_pendingCondition;
+    QWaitCondition m_freeCondition;
+    
+    QList<Chunk> m_pending;
+    QList<QByteArray> m_free;
+    
+    QByteArray m_buffer;
+    int m_bufferSize;
+    int m_bufferCount;
+    
+    bool m_closing;
+    bool m_error;
+    QString m_errorString;
+};
+
+#endif // FILEWRITER_H
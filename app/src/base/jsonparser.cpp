@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonparser.h"
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+static const int MAX_DEPTH = 512;
+
+static inline bool isWhitespace(char c) {
+    return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t');
+}
+
+static inline bool isNumberChar(char c) {
+    return ((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') || (c == 'E');
+}
+
+static inline bool isLiteralChar(char c) {
+    return (c >= 'a') && (c <= 'z');
+}
+
+static inline int hexValue(char c) {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    
+    if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    
+    return -1;
+}
+
+JsonParser::JsonParser() {
+    m_buffer.reserve(256);
+    clear();
+}
+
+void JsonParser::clear() {
+    m_state = ValueState;
+    m_escape = NoEscape;
+    m_stringIsKey = false;
+    m_allowClose = false;
+    m_unicode = 0;
+    m_unicodeDigits = 0;
+    m_highSurrogate = 0;
+    m_buffer.resize(0);
+    m_stack.clear();
+    m_result = QVariant();
+}
+
+bool JsonParser::feed(const QByteArray &data) {
+    return feed(data.constData(), data.size());
+}
+
+bool JsonParser::feed(const char *data, int size) {
+    const char *p = data;
+    const char *end = data + size;
+    
+    while (p < end) {
+        switch (m_state) {
+        case DoneState:
+            return true;
+        case ErrorState:
+            return false;
+        case StringState:
+            if (m_escape == NoEscape) {
+                const char *start = p;
+                
+                while ((p < end) && (*p != '"') && (*p != '\\')) {
+                    ++p;
+                }
+                
+                if (p > start) {
+                    flushSurrogate();
+                    m_buffer.append(start, p - start);
+                }
+                
+                if (p < end) {
+                    if (*p++ == '"') {
+                        endString();
+                    }
+                    else {
+                        m_escape = BackslashEscape;
+                    }
+                }
+            }
+            else if (m_escape == BackslashEscape) {
+                const char c = *p++;
+                
+                if (c == 'u') {
+                    m_escape = UnicodeEscape;
+                    m_unicode = 0;
+                    m_unicodeDigits = 0;
+                    break;
+                }
+                
+                flushSurrogate();
+                m_escape = NoEscape;
+                
+                switch (c) {
+                case '"':
+                case '\\':
+                case '/':
+                    m_buffer.append(c);
+                    break;
+                case 'b':
+                    m_buffer.append('\b');
+                    break;
+                case 'f':
+                    m_buffer.append('\f');
+                    break;
+                case 'n':
+                    m_buffer.append('\n');
+                    break;
+                case 'r':
+                    m_buffer.append('\r');
+                    break;
+                case 't':
+                    m_buffer.append('\t');
+                    break;
+                default:
+                    m_state = ErrorState;
+                    break;
+                }
+            }
+            else {
+                const int value = hexValue(*p++);
+                
+                if (value == -1) {
+                    m_state = ErrorState;
+                    break;
+                }
+                
+                m_unicode = (m_unicode << 4) | value;
+                
+                if (++m_unicodeDigits == 4) {
+                    m_escape = NoEscape;
+                    appendUnicode(m_unicode);
+                }
+            }
+            
+            break;
+        case NumberState:
+        case LiteralState:
+        {
+            const char *start = p;
+            
+            if (m_state == NumberState) {
+                while ((p < end) && (isNumberChar(*p))) {
+                    ++p;
+                }
+            }
+            else {
+                while ((p < end) && (isLiteralChar(*p))) {
+                    ++p;
+                }
+            }
+            
+            m_buffer.append(start, p - start);
+            
+            if (p < end) {
+                if (m_state == NumberState) {
+                    endNumber();
+                }
+                else {
+                    endLiteral();
+                }
+            }
+            
+            break;
+        }
+        default:
+        {
+            const char c = *p++;
+            
+            if (!isWhitespace(c)) {
+                parseToken(c);
+            }
+            
+            break;
+        }
+        }
+    }
+    
+    return m_state != ErrorState;
+}
+
+bool JsonParser::finish() {
+    switch (m_state) {
+    case NumberState:
+        endNumber();
+        break;
+    case LiteralState:
+        endLiteral();
+        break;
+    default:
+        break;
+    }
+#ifdef CUTETUBE_DEBUG
+    if (m_state != DoneState) {
+        qDebug() << "JsonParser::finish: Incomplete or invalid JSON";
+    }
+#endif
+    return m_state == DoneState;
+}
+
+bool JsonParser::isComplete() const {
+    return m_state == DoneState;
+}
+
+bool JsonParser::hasError() const {
+    return m_state == ErrorState;
+}
+
+QVariant JsonParser::result() const {
+    return m_result;
+}
+
+QVariant JsonParser::parse(const QByteArray &json) {
+    bool ok;
+    return parse(json, ok);
+}
+
+QVariant JsonParser::parse(const QByteArray &json, bool &ok) {
+    JsonParser parser;
+    parser.feed(json);
+    ok = parser.finish();
+    return parser.result();
+}
+
+void JsonParser::parseToken(char c) {
+    switch (m_state) {
+    case ValueState:
+        switch (c) {
+        case '{':
+            beginContainer(true);
+            return;
+        case '[':
+            beginContainer(false);
+            return;
+        case ']':
+            if ((m_allowClose) && (!m_stack.isEmpty()) && (!m_stack.last().isObject)) {
+                endContainer();
+                return;
+            }
+            
+            break;
+        case '"':
+            m_stringIsKey = false;
+            m_state = StringState;
+            return;
+        case 't':
+        case 'f':
+        case 'n':
+            m_buffer.append(c);
+            m_state = LiteralState;
+            return;
+        default:
+            if ((c == '-') || ((c >= '0') && (c <= '9'))) {
+                m_buffer.append(c);
+                m_state = NumberState;
+                return;
+            }
+            
+            break;
+        }
+        
+        break;
+    case KeyState:
+        if (c == '"') {
+            m_stringIsKey = true;
+            m_state = StringState;
+            return;
+        }
+        
+        if ((c == '}') && (m_allowClose)) {
+            endContainer();
+            return;
+        }
+        
+        break;
+    case ColonState:
+        if (c == ':') {
+            m_allowClose = false;
+            m_state = ValueState;
+            return;
+        }
+        
+        break;
+    case CommaState:
+        if (c == ',') {
+            m_allowClose = false;
+            m_state = m_stack.last().isObject ? KeyState : ValueState;
+            return;
+        }
+        
+        if (c == (m_stack.last().isObject ? '}' : ']')) {
+            endContainer();
+            return;
+        }
+        
+        break;
+    default:
+        break;
+    }
+    
+    m_state = ErrorState;
+}
+
+void JsonParser::beginContainer(bool isObject) {
+    if (m_stack.size() >= MAX_DEPTH) {
+        m_state = ErrorState;
+        return;
+    }
+    
+    Frame frame;
+    frame.isObject = isObject;
+    m_stack.append(frame);
+    m_allowClose = true;
+    m_state = isObject ? KeyState : ValueState;
+}
+
+void JsonParser::endContainer() {
+    const Frame frame = m_stack.last();
+    m_stack.pop_back();
+    addValue(frame.isObject ? QVariant(frame.map) : QVariant(frame.list));
+}
+
+void JsonParser::endString() {
+    flushSurrogate();
+    const QString s = QString::fromUtf8(m_buffer.constData(), m_buffer.size());
+    m_buffer.resize(0);
+    
+    if (m_stringIsKey) {
+        m_stack.last().key = s;
+        m_state = ColonState;
+    }
+    else {
+        addValue(s);
+    }
+}
+
+void JsonParser::endNumber() {
+    bool ok = false;
+    QVariant value;
+    
+    if ((m_buffer.contains('.')) || (m_buffer.contains('e')) || (m_buffer.contains('E'))) {
+        value = m_buffer.toDouble(&ok);
+    }
+    else if (m_buffer.startsWith('-')) {
+        value = m_buffer.toLongLong(&ok);
+    }
+    else {
+        value = m_buffer.toULongLong(&ok);
+    }
+    
+    if (!ok) {
+        value = m_buffer.toDouble(&ok);
+    }
+    
+    m_buffer.resize(0);
+    
+    if (ok) {
+        addValue(value);
+    }
+    else {
+        m_state = ErrorState;
+    }
+}
+
+void JsonParser::endLiteral() {
+    QVariant value;
+    bool ok = true;
+    
+    if (m_buffer == "true") {
+        value = true;
+    }
+    else if (m_buffer == "false") {
+        value = false;
+    }
+    else if (m_buffer != "null") {
+        ok = false;
+    }
+    
+    m_buffer.resize(0);
+    
+    if (ok) {
+        addValue(value);
+    }
+    else {
+        m_state = ErrorState;
+    }
+}
+
+void JsonParser::appendUnicode(uint code) {
+    if ((code >= 0xd800) && (code <= 0xdbff)) {
+        flushSurrogate();
+        m_highSurrogate = code;
+        return;
+    }
+    
+    if ((code >= 0xdc00) && (code <= 0xdfff)) {
+        if (!m_highSurrogate) {
+            code = 0xfffd;
+        }
+        else {
+            code = 0x10000 + ((m_highSurrogate - 0xd800) << 10) + (code - 0xdc00);
+            m_highSurrogate = 0;
+        }
+    }
+    else {
+        flushSurrogate();
+    }
+    
+    if (code < 0x80) {
+        m_buffer.append(char(code));
+    }
+    else if (code < 0x800) {
+        m_buffer.append(char(0xc0 | (code >> 6)));
+        m_buffer.append(char(0x80 | (code & 0x3f)));
+    }
+    else if (code < 0x10000) {
+        m_buffer.append(char(0xe0 | (code >> 12)));
+        m_buffer.append(char(0x80 | ((code >> 6) & 0x3f)));
+        m_buffer.append(char(0x80 | (code & 0x3f)));
+    }
+    else {
+        m_buffer.append(char(0xf0 | (code >> 18)));
+        m_buffer.append(char(0x80 | ((code >> 12) & 0x3f)));
+        m_buffer.append(char(0x80 | ((code >> 6) & 0x3f)));
+        m_buffer.append(char(0x80 | (code & 0x3f)));
+    }
+}
+
+void JsonParser::flushSurrogate() {
+    if (m_highSurrogate) {
+        m_highSurrogate = 0;
+        appendUnicode(0xfffd);
+    }
+}
+
+void JsonParser::addValue(const QVariant &value) {
+    if (m_stack.isEmpty()) {
+        m_result = value;
+        m_state = DoneState;
+        return;
+    }
+    
+    Frame &frame = m_stack.last();
+    
+    if (frame.isObject) {
+        frame.map.insert(frame.key, value);
+    }
+    else {
+        frame.list.append(value);
+    }
+    
+    m_state = CommaState;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONPARSER_H
+#define JSONPARSER_H
+
+#include <QByteArray>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QVector>
+
+class JsonParser
+{
+public:
+    JsonParser();
+    
+    void clear();
+    
+    bool feed(const QByteArray &data);
+    bool feed(const char *data, int size);
+    bool finish();
+    
+    bool isComplete() const;
+    bool hasError() const;
+    
+    QVariant result() const;
+    
+    static QVariant parse(const QByteArray &json);
+    static QVariant parse(const QByteArray &json, bool &ok);
+    
+private:
+    enum State {
+        ValueState = 0,
+        KeyState,
+        ColonState,
+        CommaState,
+        StringState,
+        NumberState,
+        LiteralState,
+        DoneState,
+        ErrorState
+    };
+    
+    enum Escape {
+        NoEscape = 0,
+        BackslashEscape,
+        UnicodeEscape
+    };
+    
+    struct Frame {
+        Frame() :
+            isObject(false)
+        {
+        }
+        
+        bool isObject;
+        QVariantMap map;
+        QVariantList list;
+        QString key;
+    };
+    
+    void parseToken(char c);
+    
+    void beginContainer(bool isObject);
+    void endContainer();
+    
+    void endString();
+    void endNumber();
+    void endLiteral();
+    
+    void appendUnicode(uint code);
+    void flushSurrogate();
+    
+    void addValue(const QVariant &value);
+    
+    State m_state;
+    Escape m_escape;
+    
+    bool m_stringIsKey;
+    bool m_allowClose;
+    
+    uint m_unicode;
+    int m_unicodeDigits;
+    uint m_highSurrogate;
+    
+    QByteArray m_buffer;
+    
+    QVector<Frame> m_stack;
+    
+    QVariant m_result;
+};
+
+#endif // JSONPARSER_H
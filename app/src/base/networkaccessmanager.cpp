@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "networkaccessmanager.h"
+#include <QCoreApplication>
+#include <QNetworkReply>
+#ifndef QT_NO_OPENSSL
+#include <QSslConfiguration>
+#endif
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+NetworkAccessManager* NetworkAccessManager::self = 0;
+
+NetworkAccessManager::NetworkAccessManager() :
+    QNetworkAccessManager(QCoreApplication::instance()),
+    m_requests(0),
+    m_secureRequests(0),
+    m_handshakes(0)
+{
+#if QT_VERSION >= 0x050100
+    connect(this, SIGNAL(encrypted(QNetworkReply*)), this, SLOT(onEncrypted(QNetworkReply*)));
+#endif
+    connect(this, SIGNAL(finished(QNetworkReply*)), this, SLOT(onFinished(QNetworkReply*)));
+}
+
+NetworkAccessManager::~NetworkAccessManager() {
+    if (self == this) {
+        self = 0;
+    }
+}
+
+NetworkAccessManager* NetworkAccessManager::instance() {
+    if (!self) {
+        self = new NetworkAccessManager;
+    }
+    
+    return self;
+}
+
+QVariantMap NetworkAccessManager::metrics() const {
+    QVariantMap m;
+    m["hosts"] = m_hosts.size();
+    m["requests"] = m_requests;
+    m["secureRequests"] = m_secureRequests;
+#if QT_VERSION >= 0x050100
+    // Handshakes are only reported through encrypted(), which Qt 4 lacks
+    m["handshakes"] = m_handshakes;
+    m["reusedConnections"] = qMax(0, m_secureRequests - m_handshakes);
+#endif
+    return m;
+}
+
+QNetworkReply* NetworkAccessManager::createRequest(Operation op, const QNetworkRequest &request,
+                                                   QIODevice *outgoingData) {
+    QNetworkRequest r(request);
+    
+    if (r.url().scheme() == "https") {
+#ifndef QT_NO_OPENSSL
+        QSslConfiguration config = r.sslConfiguration();
+        config.setSslOption(QSsl::SslOptionDisableSessionTickets, false);
+#if QT_VERSION >= 0x050200
+        config.setSslOption(QSsl::SslOptionDisableSessionSharing, false);
+#endif
+        r.setSslConfiguration(config);
+#endif
+#if QT_VERSION >= 0x050800
+        r.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+    }
+    
+    return QNetworkAccessManager::createRequest(op, r, outgoingData);
+}
+
+void NetworkAccessManager::onEncrypted(QNetworkReply *reply) {
+    m_handshakes++;
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "NetworkAccessManager::onEncrypted" << reply->url().host() << m_handshakes;
+#else
+    Q_UNUSED(reply)
+#endif
+}
+
+void NetworkAccessManager::onFinished(QNetworkReply *reply) {
+    m_requests++;
+    m_hosts.insert(reply->url().host());
+    
+    if (reply->url().scheme() == "https") {
+        m_secureRequests++;
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "NetworkAccessManager::onFinished" << metrics();
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETWORKACCESSMANAGER_H
+#define NETWORKACCESSMANAGER_H
+
+#include <QNetworkAccessManager>
+#include <QSet>
+#include <QVariantMap>
+
+class NetworkAccessManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+    
+public:
+    ~NetworkAccessManager();
+    
+    static NetworkAccessManager* instance();
+    
+    Q_INVOKABLE QVariantMap metrics() const;
+    
+protected:
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData = 0);
+    
+private:
+    NetworkAccessManager();
+    
+private Q_SLOTS:
+    void onEncrypted(QNetworkReply *reply);
+    void onFinished(QNetworkReply *reply);
+    
+private:
+    static NetworkAccessManager *self;
+    
+    QSet<QString> m_hosts;
+    
+    int m_requests;
+    int m_secureRequests;
+    int m_handshakes;
+};
+
+#endif // NETWORKACCESSMANAGER_H
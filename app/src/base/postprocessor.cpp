@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "postprocessor.h"
+#include "transfer.h"
+#include <QCoreApplication>
+#include <QThread>
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+PostProcessor* PostProcessor::self = 0;
+
+PostProcessor::PostProcessor() :
+    QObject(QCoreApplication::instance()),
+    m_maximum(qMax(1, QThread::idealThreadCount()))
+{
+}
+
+PostProcessor::~PostProcessor() {
+    if (self == this) {
+        self = 0;
+    }
+}
+
+PostProcessor* PostProcessor::instance() {
+    if (!self) {
+        self = new PostProcessor;
+    }
+    
+    return self;
+}
+
+int PostProcessor::active() const {
+    return m_active.size();
+}
+
+int PostProcessor::maximumActive() const {
+    return m_maximum;
+}
+
+int PostProcessor::queued() const {
+    return m_queue.size();
+}
+
+void PostProcessor::enqueue(Transfer *transfer) {
+    if ((!transfer) || (m_active.contains(transfer)) || (m_queue.contains(transfer))) {
+        return;
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "PostProcessor::enqueue" << transfer->id();
+#endif
+    m_queue.enqueue(transfer);
+    emit queuedChanged(queued());
+    startNext();
+}
+
+void PostProcessor::removeActiveTransfer(Transfer *transfer) {
+    if (m_active.remove(transfer)) {
+        emit activeChanged(active());
+        QMetaObject::invokeMethod(this, "startNext", Qt::QueuedConnection);
+    }
+}
+
+void PostProcessor::startNext() {
+    while ((!m_queue.isEmpty()) && (active() < maximumActive())) {
+        Transfer *transfer = m_queue.dequeue();
+        emit queuedChanged(queued());
+        
+        if ((transfer) && (transfer->status() == Transfer::Pending)) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "PostProcessor::startNext" << transfer->id();
+#endif
+            m_active.insert(transfer);
+            emit activeChanged(active());
+            connect(transfer, SIGNAL(statusChanged()), this, SLOT(onTransferStatusChanged()));
+            connect(transfer, SIGNAL(destroyed(QObject*)), this, SLOT(onTransferDestroyed(QObject*)));
+            transfer->process();
+        }
+    }
+}
+
+void PostProcessor::onTransferStatusChanged() {
+    if (Transfer *transfer = qobject_cast<Transfer*>(sender())) {
+        switch (transfer->status()) {
+        case Transfer::Converting:
+        case Transfer::Moving:
+            return;
+        default:
+            break;
+        }
+        
+        disconnect(transfer, 0, this, 0);
+        removeActiveTransfer(transfer);
+    }
+}
+
+void PostProcessor::onTransferDestroyed(QObject *obj) {
+    removeActiveTransfer(static_cast<Transfer*>(obj));
+}
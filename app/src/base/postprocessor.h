@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POSTPROCESSOR_H
+#define POSTPROCESSOR_H
+
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QSet>
+
+class Transfer;
+
+class PostProcessor : public QObject
+{
+    Q_OBJECT
+    
+    Q_PROPERTY(int active READ active NOTIFY activeChanged)
+    Q_PROPERTY(int maximumActive READ maximumActive CONSTANT)
+    Q_PROPERTY(int queued READ queued NOTIFY queuedChanged)
+    
+public:
+    ~PostProcessor();
+    
+    static PostProcessor* instance();
+    
+    int active() const;
+    int maximumActive() const;
+    int queued() const;
+    
+public Q_SLOTS:
+    void enqueue(Transfer *transfer);
+    
+private:
+    PostProcessor();
+    
+    void removeActiveTransfer(Transfer *transfer);
+    
+private Q_SLOTS:
+    void startNext();
+    
+    void onTransferStatusChanged();
+    void onTransferDestroyed(QObject *obj);
+    
+Q_SIGNALS:
+    void activeChanged(int a);
+    void queuedChanged(int q);
+    
+private:
+    static PostProcessor *self;
+    
+    int m_maximum;
+    
+    QQueue< QPointer<Transfer> > m_queue;
+    QSet<Transfer*> m_active;
+};
+
+#endif // POSTPROCESSOR_H
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ratelimiter.h"
+
+RateLimiter::RateLimiter(int rate) :
+    m_rate(qMax(0, rate)),
+    m_tokens(0)
+{
+    m_timer.start();
+}
+
+int RateLimiter::rate() const {
+    return m_rate;
+}
+
+void RateLimiter::setRate(int rate) {
+    rate = qMax(0, rate);
+    
+    if (rate != m_rate) {
+        m_rate = rate;
+        m_tokens = qMin(m_tokens, qint64(rate));
+        m_timer.restart();
+    }
+}
+
+bool RateLimiter::isLimited() const {
+    return m_rate > 0;
+}
+
+qint64 RateLimiter::available() {
+    if (!isLimited()) {
+        return -1;
+    }
+    
+    refill();
+    return qMax(qint64(0), m_tokens);
+}
+
+void RateLimiter::consume(qint64 bytes) {
+    if (isLimited()) {
+        refill();
+        m_tokens -= bytes;
+    }
+}
+
+int RateLimiter::delay() {
+    if (!isLimited()) {
+        return 0;
+    }
+    
+    refill();
+    
+    if (m_tokens > 0) {
+        return 0;
+    }
+    
+    return int((1 - m_tokens) * 1000 / m_rate) + 1;
+}
+
+void RateLimiter::refill() {
+    const qint64 tokens = m_timer.elapsed() * m_rate / 1000;
+    
+    if (tokens > 0) {
+        m_tokens = qMin(qint64(m_rate), m_tokens + tokens);
+        m_timer.restart();
+    }
+}
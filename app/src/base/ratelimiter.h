@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QElapsedTimer>
+
+class RateLimiter
+{
+public:
+    explicit RateLimiter(int rate = 0);
+    
+    int rate() const;
+    void setRate(int rate);
+    
+    bool isLimited() const;
+    
+    qint64 available();
+    void consume(qint64 bytes);
+    
+    int delay();
+    
+private:
+    void refill();
+    
+    int m_rate;
+    qint64 m_tokens;
+    QElapsedTimer m_timer;
+};
+
+#endif // RATELIMITER_H
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "responsecache.h"
+#include "definitions.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+static const quint32 CACHE_VERSION = 1;
+static const qint64 MAX_STALE_AGE = 7 * 24 * 60 * 60;
+static const int DEFAULT_TTL = 30 * 60;
+static const int SEARCH_TTL = 10 * 60;
+static const int FEED_TTL = 2 * 60;
+
+ResponseCache* ResponseCache::self = 0;
+
+ResponseCache::ResponseCache() :
+    QObject(QCoreApplication::instance()),
+    m_path(STORAGE_PATH + "cache/"),
+    m_size(0),
+    m_loaded(false)
+{
+}
+
+ResponseCache::~ResponseCache() {
+    if (self == this) {
+        self = 0;
+    }
+}
+
+ResponseCache* ResponseCache::instance() {
+    if (!self) {
+        self = new ResponseCache;
+    }
+    
+    return self;
+}
+
+QString ResponseCache::cacheKey(const QString &service, const QString &resourcePath, const QVariantMap &filters,
+                                const QVariantMap &params, const QString &userId) {
+    QStringList parts;
+    parts << service << userId << resourcePath;
+    
+    QMapIterator<QString, QVariant> filterIterator(filters);
+    
+    while (filterIterator.hasNext()) {
+        filterIterator.next();
+        parts << filterIterator.key() + "=" + filterIterator.value().toString();
+    }
+    
+    parts << QString();
+    
+    QMapIterator<QString, QVariant> paramIterator(params);
+    
+    while (paramIterator.hasNext()) {
+        paramIterator.next();
+        parts << paramIterator.key() + "=" + paramIterator.value().toString();
+    }
+    
+    return QString::fromLatin1(QCryptographicHash::hash(parts.join("\n").toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+int ResponseCache::timeToLive(const QString &resourcePath, const QVariantMap &filters) {
+    if ((resourcePath.contains("search")) || (filters.contains("search")) || (filters.contains("query"))
+        || (filters.contains("q"))) {
+        return SEARCH_TTL;
+    }
+    
+    if ((resourcePath.contains("activities")) || (resourcePath.contains("subscriptions"))
+        || (resourcePath.endsWith("/feed")) || (resourcePath.startsWith("/me/"))) {
+        return FEED_TTL;
+    }
+    
+    return DEFAULT_TTL;
+}
+
+QString ResponseCache::fileName(const QString &key) const {
+    return m_path + key;
+}
+
+void ResponseCache::load() {
+    if (m_loaded) {
+        return;
+    }
+    
+    m_loaded = true;
+    
+    foreach (const QFileInfo &info, QDir(m_path).entryInfoList(QDir::Files)) {
+        Entry entry;
+        entry.size = info.size();
+        entry.lastUsed = info.lastModified().toMSecsSinceEpoch();
+        m_entries.insert(info.fileName(), entry);
+        m_size += entry.size;
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "ResponseCache::load" << m_entries.size() << "entries," << m_size << "bytes";
+#endif
+}
+
+void ResponseCache::evict() {
+    while ((m_size > RESPONSE_CACHE_DISK_SIZE) && (!m_entries.isEmpty())) {
+        QHash<QString, Entry>::const_iterator oldest = m_entries.constBegin();
+        
+        for (QHash<QString, Entry>::const_iterator iterator = m_entries.constBegin();
+             iterator != m_entries.constEnd(); iterator++) {
+            if (iterator.value().lastUsed < oldest.value().lastUsed) {
+                oldest = iterator;
+            }
+        }
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "ResponseCache::evict" << oldest.key();
+#endif
+        remove(oldest.key());
+    }
+}
+
+QVariant ResponseCache::result(const QString &key, bool *stale) {
+    load();
+    
+    if (!m_entries.contains(key)) {
+        return QVariant();
+    }
+    
+    QFile file(fileName(key));
+    
+    if (!file.open(QFile::ReadOnly)) {
+        remove(key);
+        return QVariant();
+    }
+    
+    QDataStream stream(&file);
+    quint32 version;
+    qint64 expires;
+    QVariant result;
+    stream >> version;
+    
+    if (version == CACHE_VERSION) {
+        stream >> expires >> result;
+    }
+    
+    file.close();
+    
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+    
+    if ((version != CACHE_VERSION) || (stream.status() != QDataStream::Ok) || (expires + MAX_STALE_AGE < now)) {
+        remove(key);
+        return QVariant();
+    }
+    
+    m_entries[key].lastUsed = now * 1000;
+    
+    if (stale) {
+        *stale = (expires < now);
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "ResponseCache::result" << key << "expires in" << expires - now << "seconds";
+#endif
+    return result;
+}
+
+void ResponseCache::insert(const QString &key, const QVariant &result, int ttl) {
+    load();
+    
+    if (!QDir().mkpath(m_path)) {
+        return;
+    }
+    
+    QFile file(fileName(key));
+    
+    if (!file.open(QFile::WriteOnly)) {
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "ResponseCache::insert: Cannot open file" << file.fileName() << file.errorString();
+#endif
+        return;
+    }
+    
+    QDataStream stream(&file);
+    stream << CACHE_VERSION << QDateTime::currentMSecsSinceEpoch() / 1000 + ttl << result;
+    file.close();
+    
+    if (stream.status() != QDataStream::Ok) {
+        remove(key);
+        return;
+    }
+    
+    m_size -= m_entries.value(key).size;
+    
+    Entry entry;
+    entry.size = file.size();
+    entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    m_entries.insert(key, entry);
+    m_size += entry.size;
+    evict();
+}
+
+void ResponseCache::remove(const QString &key) {
+    if (m_entries.contains(key)) {
+        m_size -= m_entries.take(key).size;
+    }
+    
+    QFile::remove(fileName(key));
+}
+
+void ResponseCache::clear() {
+    load();
+    
+    foreach (const QString &key, m_entries.keys()) {
+        QFile::remove(fileName(key));
+    }
+    
+    m_entries.clear();
+    m_size = 0;
+}
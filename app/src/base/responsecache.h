@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QVariantMap>
+
+class ResponseCache : public QObject
+{
+    Q_OBJECT
+    
+public:
+    ~ResponseCache();
+    
+    static ResponseCache* instance();
+    
+    static QString cacheKey(const QString &service, const QString &resourcePath,
+                            const QVariantMap &filters = QVariantMap(), const QVariantMap &params = QVariantMap(),
+                            const QString &userId = QString());
+    static int timeToLive(const QString &resourcePath, const QVariantMap &filters = QVariantMap());
+    
+    QVariant result(const QString &key, bool *stale = 0);
+    
+    void insert(const QString &key, const QVariant &result, int ttl);
+    void remove(const QString &key);
+    
+public Q_SLOTS:
+    void clear();
+    
+private:
+    ResponseCache();
+    
+    QString fileName(const QString &key) const;
+    
+    void load();
+    void evict();
+    
+    struct Entry {
+        qint64 size;
+        qint64 lastUsed;
+    };
+    
+    static ResponseCache *self;
+    
+    QString m_path;
+    
+    QHash<QString, Entry> m_entries;
+    qint64 m_size;
+    bool m_loaded;
+};
+
+#endif // RESPONSECACHE_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rolelistmodel.h"
+
+RoleListModel::RoleListModel(QObject *parent) :
+    QAbstractListModel(parent),
+    m_roleTable(0)
+{
+}
+
+#if QT_VERSION >= 0x050000
+QHash<int, QByteArray> RoleListModel::roleNames() const {
+    return m_roleTable->names();
+}
+#endif
+
+QVariant RoleListModel::data(const QModelIndex &index, int role) const {
+    if (QObject *item = get(index.row())) {
+        return m_roleTable->value(item, role);
+    }
+    
+    return QVariant();
+}
+
+QMap<int, QVariant> RoleListModel::itemData(const QModelIndex &index) const {
+    if (QObject *item = get(index.row())) {
+        return m_roleTable->values(item);
+    }
+    
+    return QMap<int, QVariant>();
+}
+
+QVariant RoleListModel::data(int row, const QByteArray &role) const {
+    if (QObject *item = get(row)) {
+        return m_roleTable->value(item, role);
+    }
+    
+    return QVariant();
+}
+
+QVariantMap RoleListModel::itemData(int row) const {
+    if (QObject *item = get(row)) {
+        return m_roleTable->namedValues(item);
+    }
+    
+    return QVariantMap();
+}
+
+const AbstractRoleTable* RoleListModel::roleTable() const {
+    return m_roleTable;
+}
+
+void RoleListModel::setRoleTable(const AbstractRoleTable *table) {
+    m_roleTable = table;
+#if QT_VERSION < 0x050000
+    setRoleNames(table->names());
+#endif
+}
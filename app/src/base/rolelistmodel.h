@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROLELISTMODEL_H
+#define ROLELISTMODEL_H
+
+#include "roletable.h"
+#include <QAbstractListModel>
+
+class RoleListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit RoleListModel(QObject *parent = 0);
+    
+#if QT_VERSION >= 0x050000
+    QHash<int, QByteArray> roleNames() const;
+#endif
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const;
+    
+    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
+    Q_INVOKABLE QVariantMap itemData(int row) const;
+
+protected:
+    const AbstractRoleTable* roleTable() const;
+    void setRoleTable(const AbstractRoleTable *table);
+    
+    virtual QObject* get(int row) const = 0;
+
+private:
+    const AbstractRoleTable *m_roleTable;
+};
+
+#endif // ROLELISTMODEL_H
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROLETABLE_H
+#define ROLETABLE_H
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QVariant>
+#include <QVector>
+
+class AbstractRoleTable
+{
+
+public:
+    AbstractRoleTable() {}
+    
+    virtual ~AbstractRoleTable() {
+        qDeleteAll(m_getters);
+    }
+    
+    bool isEmpty() const {
+        return m_names.isEmpty();
+    }
+    
+    const QHash<int, QByteArray>& names() const {
+        return m_names;
+    }
+    
+    QVariant value(const QObject *item, int role) const {
+        const int i = role - Qt::UserRole - 1;
+        
+        if ((i >= 0) && (i < m_getters.size()) && (m_getters.at(i))) {
+            return m_getters.at(i)->value(item);
+        }
+        
+        return QVariant();
+    }
+    
+    QVariant value(const QObject *item, const QByteArray &name) const {
+        const int role = m_roles.value(name, -1);
+        
+        if (role != -1) {
+            return value(item, role);
+        }
+        
+        return item->property(name);
+    }
+    
+    QMap<int, QVariant> values(const QObject *item) const {
+        QMap<int, QVariant> map;
+        QHashIterator<int, QByteArray> iterator(m_names);
+        
+        while (iterator.hasNext()) {
+            iterator.next();
+            map[iterator.key()] = value(item, iterator.key());
+        }
+        
+        return map;
+    }
+    
+    QVariantMap namedValues(const QObject *item) const {
+        QVariantMap map;
+        QHashIterator<int, QByteArray> iterator(m_names);
+        
+        while (iterator.hasNext()) {
+            iterator.next();
+            map[iterator.value()] = value(item, iterator.key());
+        }
+        
+        return map;
+    }
+
+protected:
+    class Getter
+    {
+    
+    public:
+        virtual ~Getter() {}
+        
+        virtual QVariant value(const QObject *item) const = 0;
+    };
+    
+    void insertGetter(int role, const QByteArray &name, Getter *getter) {
+        const int i = role - Qt::UserRole - 1;
+        
+        if (i < 0) {
+            delete getter;
+            return;
+        }
+        
+        if (i >= m_getters.size()) {
+            m_getters.resize(i + 1);
+        }
+        
+        delete m_getters.at(i);
+        m_getters[i] = getter;
+        m_names[role] = name;
+        m_roles[name] = role;
+    }
+
+private:
+    Q_DISABLE_COPY(AbstractRoleTable)
+    
+    QVector<Getter*> m_getters;
+    QHash<int, QByteArray> m_names;
+    QHash<QByteArray, int> m_roles;
+};
+
+template <class T>
+class RoleTable : public AbstractRoleTable
+{
+
+public:
+    RoleTable() {}
+    
+    void insert(int role, const QByteArray &name) {
+        insertGetter(role, name, 0);
+    }
+    
+    template <class C, class R>
+    void insert(int role, const QByteArray &name, R (C::*method)() const) {
+        insertGetter(role, name, new MethodGetter<C, R>(method));
+    }
+
+private:
+    template <class C, class R>
+    class MethodGetter : public Getter
+    {
+    
+    public:
+        explicit MethodGetter(R (C::*method)() const) :
+            m_method(method)
+        {
+        }
+        
+        QVariant value(const QObject *item) const {
+            return QVariant((static_cast<const T*>(item)->*m_method)());
+        }
+    
+    private:
+        R (C::*m_method)() const;
+    };
+    
+    Q_DISABLE_COPY(RoleTable)
+};
+
+#endif // ROLETABLE_H
@@ -17,12 +17,15 @@
 #include "settings.h"
 #include "definitions.h"
 #include "resources.h"
+#include <QCoreApplication>
 #include <QSettings>
 #include <QNetworkProxy>
 #ifdef CUTETUBE_DEBUG
 #include <QDebug>
 #endif
 
+static const int FLUSH_INTERVAL = 1000;
+
 Settings* Settings::self = 0;
 
 Settings::Settings(QObject *parent) :
@@ -31,9 +34,23 @@ Settings::Settings(QObject *parent) :
     if (!self) {
         self = this;
     }
+    
+    QSettings settings;
+    
+    foreach (const QString &key, settings.allKeys()) {
+        m_values[key] = settings.value(key);
+    }
+    
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_INTERVAL);
+    
+    connect(&m_flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+    connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(flush()));
 }
 
 Settings::~Settings() {
+    flush();
+    
     if (self == this) {
         self = 0;
     }
@@ -67,44 +84,67 @@ void Settings::setActiveColorString(const QString &s) {
 }
 #endif
 
+bool Settings::adaptiveConcurrency() const {
+    return value("Transfers/adaptiveConcurrency", false).toBool();
+}
+
+void Settings::setAdaptiveConcurrency(bool enabled) {
+    if (enabled != adaptiveConcurrency()) {
+        setValue("Transfers/adaptiveConcurrency", enabled);
+        emit adaptiveConcurrencyChanged();
+    }
+}
+
 QStringList Settings::categoryNames() const {
-    QSettings settings;
-    settings.beginGroup("Categories");
-    QStringList names = settings.childKeys();
+    QStringList names = childKeys("Categories");
     names.prepend(tr("Default"));
-    settings.endGroup();
     
     return names;
 }
 
 QList<Category> Settings::categories() const {
     QList<Category> list;
-    QSettings settings;
-    settings.beginGroup("Categories");
     
-    foreach (QString key, settings.childKeys()) {
+    foreach (QString key, childKeys("Categories")) {
         Category category;
         category.name = key;
-        category.path = settings.value(key).toString();
+        category.path = value("Categories/" + key).toString();
         list << category;
     }
     
-    settings.endGroup();
-    
     return list;
 }
 
 void Settings::setCategories(const QList<Category> &c) {
-    QSettings settings;
-    settings.remove("Categories");
-    settings.beginGroup("Categories");
+    QHash<QString, QVariant> values;
     
     foreach (Category category, c) {
-        settings.setValue(category.name, category.path);
+        values["Categories/" + category.name] = category.path;
+    }
+    
+    bool changed = false;
+    
+    foreach (QString key, childKeys("Categories")) {
+        if (!values.contains("Categories/" + key)) {
+            remove("Categories/" + key);
+            changed = true;
+        }
     }
     
-    settings.endGroup();
-    emit categoriesChanged();
+    QHashIterator<QString, QVariant> iterator(values);
+    
+    while (iterator.hasNext()) {
+        iterator.next();
+        
+        if (iterator.value() != value(iterator.key())) {
+            setValue(iterator.key(), iterator.value());
+            changed = true;
+        }
+    }
+    
+    if (changed) {
+        emit categoriesChanged();
+    }
 }
 
 void Settings::addCategory(const QString &name, const QString &path) {
@@ -115,15 +155,10 @@ void Settings::addCategory(const QString &name, const QString &path) {
 }
 
 void Settings::removeCategory(const QString &name) {
-    QSettings settings;
-    settings.beginGroup("Categories");
-    
-    if (settings.contains(name)) {
-        settings.remove(name);
+    if (m_values.contains("Categories/" + name)) {
+        remove("Categories/" + name);
         emit categoriesChanged();
     }
-    
-    settings.endGroup();
 }
 
 QString Settings::defaultCategory() const {
@@ -224,6 +259,17 @@ void Settings::setDownloadPath(const QString &path) {
     }
 }
 
+int Settings::downloadSegments() const {
+    return qBound(1, value("Transfers/downloadSegments", 1).toInt(), MAX_DOWNLOAD_SEGMENTS);
+}
+
+void Settings::setDownloadSegments(int segments) {
+    if (segments != downloadSegments()) {
+        setValue("Transfers/downloadSegments", qBound(1, segments, MAX_DOWNLOAD_SEGMENTS));
+        emit downloadSegmentsChanged();
+    }
+}
+
 QString Settings::locale() const {
     return value("Content/locale", QLocale().name()).toString();
 }
@@ -246,6 +292,28 @@ void Settings::setMaximumConcurrentTransfers(int maximum) {
     }
 }
 
+int Settings::maximumDownloadSpeed() const {
+    return qMax(0, value("Transfers/maximumDownloadSpeed", 0).toInt());
+}
+
+void Settings::setMaximumDownloadSpeed(int speed) {
+    if (speed != maximumDownloadSpeed()) {
+        setValue("Transfers/maximumDownloadSpeed", qMax(0, speed));
+        emit maximumDownloadSpeedChanged();
+    }
+}
+
+int Settings::maximumDownloadSpeed(const QString &service) const {
+    return qMax(0, value("DownloadSpeeds/" + service, 0).toInt());
+}
+
+void Settings::setMaximumDownloadSpeed(const QString &service, int speed) {
+    if (speed != maximumDownloadSpeed(service)) {
+        setValue("DownloadSpeeds/" + service, qMax(0, speed));
+        emit maximumDownloadSpeedChanged();
+    }
+}
+
 void Settings::setNetworkProxy() {
     if (!networkProxyEnabled()) {
         QNetworkProxy::setApplicationProxy(QNetworkProxy());
@@ -330,6 +398,17 @@ void Settings::setNetworkProxyUsername(const QString &username) {
     }
 }
 
+int Settings::prefetchThreshold() const {
+    return qMax(0, value("Content/prefetchThreshold", 10).toInt());
+}
+
+void Settings::setPrefetchThreshold(int threshold) {
+    if (threshold != prefetchThreshold()) {
+        setValue("Content/prefetchThreshold", qMax(0, threshold));
+        emit prefetchThresholdChanged();
+    }
+}
+
 bool Settings::safeSearchEnabled() const {
     return value("Search/safeSearchEnabled", false).toBool();
 }
@@ -361,8 +440,10 @@ QStringList Settings::searchHistory() const {
 }
 
 void Settings::setSearchHistory(const QStringList &searches) {
-    setValue("Search/searchHistory", searches);
-    emit searchHistoryChanged();
+    if (searches != searchHistory()) {
+        setValue("Search/searchHistory", searches);
+        emit searchHistoryChanged();
+    }
 }
 
 void Settings::addSearch(const QString &query) {
@@ -412,14 +493,79 @@ void Settings::setSubtitlesLanguage(const QString &language) {
 }
 
 QVariant Settings::value(const QString &key, const QVariant &defaultValue) const {
-    return QSettings().value(key, defaultValue);
+    return m_values.value(key, defaultValue);
 }
 
 void Settings::setValue(const QString &key, const QVariant &value) {
-    QSettings().setValue(key, value);
+    if ((m_values.contains(key)) && (m_values.value(key) == value)) {
+        return;
+    }
+    
+    m_values[key] = value;
+    m_changed.insert(key);
+    
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
 #ifdef CUTETUBE_DEBUG
     qDebug() << "Settings::setValue" << key << value;
 #endif
+    emit valueChanged(key, value);
+}
+
+void Settings::remove(const QString &key) {
+    if (m_values.remove(key) > 0) {
+        m_changed.insert(key);
+        
+        if (!m_flushTimer.isActive()) {
+            m_flushTimer.start();
+        }
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "Settings::remove" << key;
+#endif
+        emit valueChanged(key, QVariant());
+    }
+}
+
+void Settings::flush() {
+    m_flushTimer.stop();
+    
+    if (m_changed.isEmpty()) {
+        return;
+    }
+    
+    QSettings settings;
+    
+    foreach (const QString &key, m_changed) {
+        if (m_values.contains(key)) {
+            settings.setValue(key, m_values.value(key));
+        }
+        else {
+            settings.remove(key);
+        }
+    }
+    
+    m_changed.clear();
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Settings::flush";
+#endif
+}
+
+QStringList Settings::childKeys(const QString &group) const {
+    const QString prefix = group + "/";
+    QStringList keys;
+    QHashIterator<QString, QVariant> iterator(m_values);
+    
+    while (iterator.hasNext()) {
+        iterator.next();
+        
+        if ((iterator.key().startsWith(prefix)) && (iterator.key().indexOf('/', prefix.size()) == -1)) {
+            keys << iterator.key().mid(prefix.size());
+        }
+    }
+    
+    keys.sort();
+    return keys;
 }
 
 QString Settings::videoPlayer() const {
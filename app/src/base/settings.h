@@ -18,7 +18,9 @@
 #define SETTINGS_H
 
 #include <QObject>
+#include <QSet>
 #include <QStringList>
+#include <QTimer>
 #include <QVariant>
 #include <qplatformdefs.h>
 
@@ -36,6 +38,8 @@ class Settings : public QObject
     Q_PROPERTY(QString activeColorString READ activeColorString WRITE setActiveColorString
                NOTIFY activeColorStringChanged)
 #endif
+    Q_PROPERTY(bool adaptiveConcurrency READ adaptiveConcurrency WRITE setAdaptiveConcurrency
+               NOTIFY adaptiveConcurrencyChanged)
     Q_PROPERTY(QStringList categoryNames READ categoryNames NOTIFY categoriesChanged)
     Q_PROPERTY(QString defaultCategory READ defaultCategory WRITE setDefaultCategory NOTIFY defaultCategoryChanged)
     Q_PROPERTY(bool clipboardMonitorEnabled READ clipboardMonitorEnabled WRITE setClipboardMonitorEnabled
@@ -43,9 +47,12 @@ class Settings : public QObject
     Q_PROPERTY(QString currentService READ currentService WRITE setCurrentService NOTIFY currentServiceChanged)
     Q_PROPERTY(QString defaultViewMode READ defaultViewMode WRITE setDefaultViewMode NOTIFY defaultViewModeChanged)
     Q_PROPERTY(QString downloadPath READ downloadPath WRITE setDownloadPath NOTIFY downloadPathChanged)
+    Q_PROPERTY(int downloadSegments READ downloadSegments WRITE setDownloadSegments NOTIFY downloadSegmentsChanged)
     Q_PROPERTY(QString locale READ locale WRITE setLocale NOTIFY localeChanged)
     Q_PROPERTY(int maximumConcurrentTransfers READ maximumConcurrentTransfers WRITE setMaximumConcurrentTransfers
                NOTIFY maximumConcurrentTransfersChanged)
+    Q_PROPERTY(int maximumDownloadSpeed READ maximumDownloadSpeed WRITE setMaximumDownloadSpeed
+               NOTIFY maximumDownloadSpeedChanged)
     Q_PROPERTY(bool networkProxyEnabled READ networkProxyEnabled WRITE setNetworkProxyEnabled
                NOTIFY networkProxyChanged)
     Q_PROPERTY(QString networkProxyHost READ networkProxyHost WRITE setNetworkProxyHost NOTIFY networkProxyChanged)
@@ -55,6 +62,8 @@ class Settings : public QObject
     Q_PROPERTY(int networkProxyType READ networkProxyType WRITE setNetworkProxyType NOTIFY networkProxyChanged)
     Q_PROPERTY(QString networkProxyUsername READ networkProxyUsername WRITE setNetworkProxyUsername
                NOTIFY networkProxyChanged)
+    Q_PROPERTY(int prefetchThreshold READ prefetchThreshold WRITE setPrefetchThreshold
+               NOTIFY prefetchThresholdChanged)
     Q_PROPERTY(bool safeSearchEnabled READ safeSearchEnabled WRITE setSafeSearchEnabled NOTIFY safeSearchEnabledChanged)
     Q_PROPERTY(int screenOrientation READ screenOrientation WRITE setScreenOrientation NOTIFY screenOrientationChanged)
     Q_PROPERTY(QStringList searchHistory READ searchHistory WRITE setSearchHistory NOTIFY searchHistoryChanged)
@@ -80,6 +89,8 @@ public:
     QString activeColorString() const;
 #endif
     
+    bool adaptiveConcurrency() const;
+    
     QStringList categoryNames() const;
     QList<Category> categories() const;
     void setCategories(const QList<Category> &c);
@@ -100,10 +111,15 @@ public:
     QString downloadPath() const;
     Q_INVOKABLE QString downloadPath(const QString &category) const;
     
+    int downloadSegments() const;
+    
     QString locale() const;
         
     int maximumConcurrentTransfers() const;
     
+    int maximumDownloadSpeed() const;
+    Q_INVOKABLE int maximumDownloadSpeed(const QString &service) const;
+    
     bool networkProxyEnabled() const;
     QString networkProxyHost() const;
     QString networkProxyPassword() const;
@@ -111,6 +127,8 @@ public:
     int networkProxyType() const;
     QString networkProxyUsername() const;
     
+    int prefetchThreshold() const;
+    
     bool safeSearchEnabled() const;
     
     int screenOrientation() const;
@@ -135,6 +153,8 @@ public Q_SLOTS:
     void setActiveColor(const QString &color);
     void setActiveColorString(const QString &s);
 #endif
+    void setAdaptiveConcurrency(bool enabled);
+    
     void addCategory(const QString &name, const QString &path);
     void setDefaultCategory(const QString &category);
     void removeCategory(const QString &name);
@@ -152,10 +172,15 @@ public Q_SLOTS:
     
     void setDownloadPath(const QString &path);
     
+    void setDownloadSegments(int segments);
+    
     void setLocale(const QString &name);
     
     void setMaximumConcurrentTransfers(int maximum);
     
+    void setMaximumDownloadSpeed(int speed);
+    void setMaximumDownloadSpeed(const QString &service, int speed);
+    
     void setNetworkProxy();
     void setNetworkProxyEnabled(bool enabled);
     void setNetworkProxyHost(const QString &host);
@@ -164,6 +189,8 @@ public Q_SLOTS:
     void setNetworkProxyType(int type);
     void setNetworkProxyUsername(const QString &username);
     
+    void setPrefetchThreshold(int threshold);
+    
     void setSafeSearchEnabled(bool enabled);
     
     void setScreenOrientation(int orientation);
@@ -177,6 +204,9 @@ public Q_SLOTS:
     void setSubtitlesLanguage(const QString &language);
 
     void setValue(const QString &key, const QVariant &value);
+    void remove(const QString &key);
+    
+    void flush();
     
     void setVideoPlayer(const QString &player);
 #ifndef SYMBIAN_OS
@@ -188,6 +218,7 @@ Q_SIGNALS:
     void activeColorChanged();
     void activeColorStringChanged();
 #endif
+    void adaptiveConcurrencyChanged();
     void categoriesChanged();
     void defaultCategoryChanged();
     void clipboardMonitorEnabledChanged();
@@ -197,10 +228,13 @@ Q_SIGNALS:
     void defaultViewModeChanged();
     void downloadFormatsChanged();
     void downloadPathChanged();
+    void downloadSegmentsChanged();
     void localeChanged();
     void maximumConcurrentTransfersChanged();
+    void maximumDownloadSpeedChanged();
     void networkProxyChanged();
     void playbackFormatsChanged();
+    void prefetchThresholdChanged();
     void safeSearchEnabledChanged();
     void screenOrientationChanged();
     void searchHistoryChanged();
@@ -211,9 +245,17 @@ Q_SIGNALS:
 #ifndef SYMBIAN_OS
     void videoPlayerCommandChanged();
 #endif
+    void valueChanged(const QString &key, const QVariant &value);
 
 private:
+    QStringList childKeys(const QString &group) const;
+    
     static Settings *self;
+    
+    QHash<QString, QVariant> m_values;
+    QSet<QString> m_changed;
+    
+    QTimer m_flushTimer;
 };
     
 #endif // SETTINGS_H
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streamcache.h"
+#include "resources.h"
+#include "resourcesrequest.h"
+#include <qdailymotion/streamsrequest.h>
+#include <qvimeo/streamsrequest.h>
+#include <qyoutube/streamsrequest.h>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QUrl>
+#if QT_VERSION >= 0x050000
+#include <QUrlQuery>
+#endif
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+static const int MAX_ENTRIES = 50;
+static const int MAX_PREFETCH_REQUESTS = 2;
+static const qint64 DEFAULT_EXPIRY = 1800;
+static const qint64 EXPIRY_MARGIN = 60;
+
+StreamCache* StreamCache::self = 0;
+
+StreamCache::StreamCache() :
+    QObject(QCoreApplication::instance())
+{
+}
+
+StreamCache::~StreamCache() {
+    if (self == this) {
+        self = 0;
+    }
+}
+
+StreamCache* StreamCache::instance() {
+    if (!self) {
+        self = new StreamCache;
+    }
+    
+    return self;
+}
+
+QString StreamCache::cacheKey(const QString &service, const QString &id) {
+    return service + "/" + id;
+}
+
+qint64 StreamCache::expiryTime(const QVariantList &streams) {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+    qint64 expires = now + DEFAULT_EXPIRY;
+    
+    foreach (const QVariant &v, streams) {
+        const QUrl url = v.toMap().value("url").toUrl();
+#if QT_VERSION >= 0x050000
+        const QUrlQuery query(url);
+#endif
+        foreach (const QString &key, QStringList() << "expire" << "expires" << "exp") {
+#if QT_VERSION >= 0x050000
+            const qint64 e = query.queryItemValue(key).toLongLong();
+#else
+            const qint64 e = url.queryItemValue(key).toLongLong();
+#endif
+            if (e > now) {
+                expires = qMin(expires, e - EXPIRY_MARGIN);
+                break;
+            }
+        }
+    }
+    
+    return expires;
+}
+
+QVariantList StreamCache::streams(const QString &service, const QString &id) {
+    const QString key = cacheKey(service, id);
+    QHash<QString, Entry>::iterator iterator = m_entries.find(key);
+    
+    if (iterator == m_entries.end()) {
+        return QVariantList();
+    }
+    
+    if (iterator.value().expires <= QDateTime::currentMSecsSinceEpoch() / 1000) {
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "StreamCache::streams: Expired" << key;
+#endif
+        m_entries.erase(iterator);
+        return QVariantList();
+    }
+    
+    return iterator.value().streams;
+}
+
+QVariantMap StreamCache::stream(const QString &service, const QString &id, const QString &streamId) {
+    foreach (const QVariant &v, streams(service, id)) {
+        const QVariantMap s = v.toMap();
+        
+        if (s.value("id") == streamId) {
+            return s;
+        }
+    }
+    
+    return QVariantMap();
+}
+
+void StreamCache::insert(const QString &service, const QString &id, const QVariantList &streams) {
+    if ((service.isEmpty()) || (id.isEmpty()) || (streams.isEmpty())) {
+        return;
+    }
+    
+    if (m_entries.size() >= MAX_ENTRIES) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+        QHash<QString, Entry>::iterator oldest = m_entries.end();
+        QHash<QString, Entry>::iterator iterator = m_entries.begin();
+        
+        while (iterator != m_entries.end()) {
+            if (iterator.value().expires <= now) {
+                iterator = m_entries.erase(iterator);
+            }
+            else {
+                if ((oldest == m_entries.end()) || (iterator.value().expires < oldest.value().expires)) {
+                    oldest = iterator;
+                }
+                
+                ++iterator;
+            }
+        }
+        
+        if ((m_entries.size() >= MAX_ENTRIES) && (oldest != m_entries.end())) {
+            m_entries.erase(oldest);
+        }
+    }
+    
+    Entry entry;
+    entry.streams = streams;
+    entry.expires = expiryTime(streams);
+    m_entries[cacheKey(service, id)] = entry;
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "StreamCache::insert" << service << id << entry.expires;
+#endif
+}
+
+void StreamCache::remove(const QString &service, const QString &id) {
+    m_entries.remove(cacheKey(service, id));
+}
+
+void StreamCache::prefetch(const QString &service, const QString &id) {
+    if ((service.isEmpty()) || (id.isEmpty())) {
+        return;
+    }
+    
+    const QString key = cacheKey(service, id);
+    
+    if ((m_prefetching.contains(key)) || (m_prefetchQueue.contains(key)) || (!streams(service, id).isEmpty())) {
+        return;
+    }
+    
+    m_prefetchQueue << key;
+    prefetchNext();
+}
+
+void StreamCache::prefetchNext() {
+    while ((!m_prefetchQueue.isEmpty()) && (m_prefetching.size() < MAX_PREFETCH_REQUESTS)) {
+        const QString key = m_prefetchQueue.takeFirst();
+        const int i = key.indexOf('/');
+        const QString service = key.left(i);
+        const QString id = key.mid(i + 1);
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "StreamCache::prefetchNext" << service << id;
+#endif
+        m_prefetching.insert(key);
+        
+        if (service == Resources::YOUTUBE) {
+            QYouTube::StreamsRequest *request = new QYouTube::StreamsRequest(this);
+            request->setProperty("cacheKey", key);
+            connect(request, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+            request->list(id);
+        }
+        else if (service == Resources::DAILYMOTION) {
+            QDailymotion::StreamsRequest *request = new QDailymotion::StreamsRequest(this);
+            request->setProperty("cacheKey", key);
+            connect(request, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+            request->list(id);
+        }
+        else if (service == Resources::VIMEO) {
+            QVimeo::StreamsRequest *request = new QVimeo::StreamsRequest(this);
+            request->setProperty("cacheKey", key);
+            connect(request, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+            request->list(id);
+        }
+        else {
+            ResourcesRequest *request = new ResourcesRequest(this);
+            request->setProperty("cacheKey", key);
+            request->setService(service);
+            connect(request, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+            request->list(Resources::STREAM, id);
+        }
+    }
+}
+
+void StreamCache::onPrefetchRequestFinished() {
+    QObject *request = sender();
+    
+    if (!request) {
+        return;
+    }
+    
+    const QString key = request->property("cacheKey").toString();
+    const int i = key.indexOf('/');
+    QVariantList streams;
+    
+    if (QYouTube::StreamsRequest *r = qobject_cast<QYouTube::StreamsRequest*>(request)) {
+        if (r->status() == QYouTube::StreamsRequest::Ready) {
+            streams = r->result().toList();
+        }
+    }
+    else if (QDailymotion::StreamsRequest *r = qobject_cast<QDailymotion::StreamsRequest*>(request)) {
+        if (r->status() == QDailymotion::StreamsRequest::Ready) {
+            streams = r->result().toList();
+        }
+    }
+    else if (QVimeo::StreamsRequest *r = qobject_cast<QVimeo::StreamsRequest*>(request)) {
+        if (r->status() == QVimeo::StreamsRequest::Ready) {
+            streams = r->result().toList();
+        }
+    }
+    else if (ResourcesRequest *r = qobject_cast<ResourcesRequest*>(request)) {
+        if (r->status() == ResourcesRequest::Ready) {
+            streams = r->result().toMap().value("items").toList();
+        }
+    }
+    
+    insert(key.left(i), key.mid(i + 1), streams);
+    m_prefetching.remove(key);
+    request->deleteLater();
+    prefetchNext();
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMCACHE_H
+#define STREAMCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVariantList>
+
+class StreamCache : public QObject
+{
+    Q_OBJECT
+    
+public:
+    ~StreamCache();
+    
+    static StreamCache* instance();
+    
+    QVariantList streams(const QString &service, const QString &id);
+    QVariantMap stream(const QString &service, const QString &id, const QString &streamId);
+    
+    void insert(const QString &service, const QString &id, const QVariantList &streams);
+    void remove(const QString &service, const QString &id);
+    
+public Q_SLOTS:
+    void prefetch(const QString &service, const QString &id);
+    
+private:
+    StreamCache();
+    
+    static QString cacheKey(const QString &service, const QString &id);
+    static qint64 expiryTime(const QVariantList &streams);
+    
+    void prefetchNext();
+    
+private Q_SLOTS:
+    void onPrefetchRequestFinished();
+    
+private:
+    struct Entry {
+        QVariantList streams;
+        qint64 expires;
+    };
+    
+    static StreamCache *self;
+    
+    QHash<QString, Entry> m_entries;
+    
+    QStringList m_prefetchQueue;
+    QSet<QString> m_prefetching;
+};
+
+#endif // STREAMCACHE_H
@@ -17,11 +17,16 @@
 #include "transfer.h"
 #include "audioconverter.h"
 #include "definitions.h"
+#include "filewriter.h"
+#include "networkaccessmanager.h"
+#include "postprocessor.h"
+#include "ratelimiter.h"
 #include "settings.h"
-#include <QNetworkAccessManager>
+#include "streamcache.h"
 #include <QNetworkReply>
 #include <QFile>
 #include <QDir>
+#include <QStringList>
 #ifdef MEEGO_EDITION_HARMATTAN
 #include <TransferUI/Client>
 #include <TransferUI/Transfer>
@@ -33,26 +38,54 @@
 #ifdef MEEGO_EDITION_HARMATTAN
 TransferUI::Client* Transfer::tuiClient = 0;
 #endif
-#ifdef SYMBIAN_OS
-static const qint64 BUFFER_SIZE = 1024 * 512;
-#endif
+static const qint64 READ_BUFFER_SIZE = 1024 * 256;
+static const int RATE_LIMIT_INTERVAL = 100;
+static const double SPEED_SMOOTHING = 0.3;
+
+static const QStringList AUDIO_EXTENSIONS = QStringList() << "m4a" << "aac" << "mp3" << "ogg" << "oga" << "opus";
+
+inline static bool isAudioFileName(const QString &fileName) {
+    return AUDIO_EXTENSIONS.contains(fileName.section('.', -1).toLower());
+}
+
+inline static bool hasAudioExtension(const QVariantMap &stream) {
+    return AUDIO_EXTENSIONS.contains(stream.value("ext").toString().toLower());
+}
+
+inline static bool isAudioStream(const QVariantMap &stream) {
+    if (stream.value("height").toInt() > 0) {
+        return false;
+    }
+    
+    if (hasAudioExtension(stream)) {
+        return true;
+    }
+    
+    const QString ext = stream.value("ext").toString().toLower();
+    return ((ext.isEmpty()) || (ext == "mp4"))
+           && (stream.value("description").toString().contains("audio", Qt::CaseInsensitive));
+}
 
 Transfer::Transfer(QObject *parent) :
     QObject(parent),
     m_audioConverter(0),
-    m_nam(0),
+    m_nam(NetworkAccessManager::instance()),
     m_reply(0),
-    m_ownNetworkAccessManager(false),
+    m_subtitlesReply(0),
+    m_writer(new FileWriter(this)),
     m_canceled(false),
     m_canConvertToAudio(false),
     m_canConvertToAudioChecked(false),
     m_convertToAudio(false),
     m_category(tr("Default")),
     m_downloadSubtitles(false),
+    m_subtitlesRunning(false),
     m_priority(NormalPriority),
     m_progress(0),
     m_size(0),
     m_bytesTransferred(0),
+    m_lastBytesTransferred(0),
+    m_speed(0),
     m_redirects(0),
     m_status(Paused),
     m_transferType(Download)
@@ -75,6 +108,8 @@ Transfer::Transfer(QObject *parent) :
     connect(m_tuiTransfer, SIGNAL(cancel()), this, SLOT(cancel()));
     connect(m_tuiTransfer, SIGNAL(repairError()), this, SLOT(queue()));
 #endif
+    m_rateTimer.setSingleShot(true);
+    connect(&m_rateTimer, SIGNAL(timeout()), this, SLOT(onRateTimerTimeout()));
 }
 
 Transfer::~Transfer() {
@@ -91,12 +126,11 @@ Transfer::~Transfer() {
 }
 
 void Transfer::setNetworkAccessManager(QNetworkAccessManager *manager) {
-    if ((m_nam) && (m_ownNetworkAccessManager)) {
-        delete m_nam;
-    }
-    
-    m_nam = manager;
-    m_ownNetworkAccessManager = false;
+    m_nam = manager ? manager : NetworkAccessManager::instance();
+}
+
+void Transfer::setRateLimiters(const QList<RateLimiter*> &limiters) {
+    m_rateLimiters = limiters;
 }
 
 qint64 Transfer::bytesTransferred() const {
@@ -234,6 +268,10 @@ void Transfer::setFileName(const QString &name) {
 #endif
 }
 
+QString Transfer::host() const {
+    return m_host;
+}
+
 QString Transfer::id() const {
     return m_id;
 }
@@ -279,6 +317,36 @@ int Transfer::progress() const {
     return m_progress;
 }
 
+bool Transfer::updateProgress() {
+    if ((status() != Downloading) || (!m_progressTimer.isValid())) {
+        return false;
+    }
+    
+    const qint64 msecs = m_progressTimer.elapsed();
+    
+    if (msecs <= 0) {
+        return false;
+    }
+    
+    m_progressTimer.restart();
+    const qint64 bytes = qMax(qint64(0), m_bytesTransferred - m_lastBytesTransferred);
+    const qint64 rate = bytes * 1000 / msecs;
+    const qint64 average = (m_speed == 0) ? rate
+                                          : qint64(SPEED_SMOOTHING * rate + (1 - SPEED_SMOOTHING) * m_speed);
+    const bool changed = (bytes > 0) || (average != m_speed);
+    m_lastBytesTransferred = m_bytesTransferred;
+    m_speed = average;
+    
+    if ((m_size > 0) && (m_bytesTransferred * 100 / m_size != progress())) {
+        setProgress(m_bytesTransferred * 100 / m_size);
+    }
+    else if (changed) {
+        emit progressChanged();
+    }
+    
+    return changed;
+}
+
 void Transfer::setProgress(int p) {
     if (p != progress()) {
         m_progress = p;
@@ -307,6 +375,59 @@ void Transfer::setResourceId(const QString &ri) {
 #endif
 }
 
+QVariantList Transfer::segments() const {
+    QVariantList list;
+    
+    foreach (const TransferSegment &segment, m_segments) {
+        QVariantMap map;
+        map["start"] = segment.start;
+        map["end"] = segment.end;
+        map["bytesTransferred"] = segment.bytesTransferred;
+        list << map;
+    }
+    
+    return list;
+}
+
+void Transfer::setSegments(const QVariantList &s) {
+    m_segments.clear();
+    
+    if (s.isEmpty()) {
+        return;
+    }
+    
+    m_bytesTransferred = 0;
+    
+    foreach (const QVariant &v, s) {
+        const QVariantMap map = v.toMap();
+        TransferSegment segment;
+        segment.start = map.value("start").toLongLong();
+        segment.end = map.value("end").toLongLong();
+        segment.bytesTransferred = map.value("bytesTransferred").toLongLong();
+        m_segments << segment;
+        m_bytesTransferred += segment.bytesTransferred;
+    }
+    
+    if (m_size > 0) {
+        setProgress(m_bytesTransferred * 100 / m_size);
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Transfer::setSegments" << s;
+#endif
+}
+
+qint64 Transfer::speed() const {
+    return m_speed;
+}
+
+int Transfer::eta() const {
+    if ((m_speed > 0) && (m_size > m_bytesTransferred)) {
+        return int((m_size - m_bytesTransferred) / m_speed);
+    }
+    
+    return -1;
+}
+
 QString Transfer::service() const {
     return m_service;
 }
@@ -349,7 +470,28 @@ Transfer::Status Transfer::status() const {
 
 void Transfer::setStatus(Status s) {
     if (s != status()) {
+        const bool downloading = (m_status == Downloading);
         m_status = s;
+        
+        if (s == Downloading) {
+            m_lastBytesTransferred = m_bytesTransferred;
+            m_progressTimer.start();
+        }
+        else if (downloading) {
+            m_speed = 0;
+            
+            if ((m_size > 0) && (m_bytesTransferred * 100 / m_size != progress())) {
+                setProgress(m_bytesTransferred * 100 / m_size);
+            }
+            else {
+                emit progressChanged();
+            }
+        }
+        
+        if (s == Failed) {
+            StreamCache::instance()->remove(service(), resourceId());
+        }
+        
         emit statusChanged();
 #ifdef MEEGO_EDITION_HARMATTAN
         switch (s) {
@@ -401,6 +543,10 @@ QString Transfer::statusString() const {
         return tr("Uploading");
     case Converting:
         return tr("Converting");
+    case Pending:
+        return tr("Pending");
+    case Moving:
+        return tr("Moving");
     default:
         return QString();
     }
@@ -483,7 +629,30 @@ void Transfer::setTransferType(TransferType type) {
 }
 
 QUrl Transfer::url() const {
-    return m_reply ? m_reply->url() : QUrl();
+    if (m_reply) {
+        return m_reply->url();
+    }
+    
+    foreach (const TransferSegment &segment, m_segments) {
+        if (segment.reply) {
+            return segment.reply->url();
+        }
+    }
+    
+    return QUrl();
+}
+
+void Transfer::process() {
+    if (status() != Pending) {
+        return;
+    }
+    
+    if ((convertToAudio()) && (!isAudioFileName(m_file.fileName()))) {
+        startAudioConversion();
+    }
+    else {
+        moveDownloadedFiles();
+    }
 }
 
 void Transfer::queue() {
@@ -495,11 +664,19 @@ void Transfer::queue() {
     case Downloading:
     case Uploading:
     case Converting:
+    case Pending:
+    case Moving:
         return;
     default:
         break;
     }
     
+    if ((size() > 0) && (bytesTransferred() >= size())) {
+        startSubtitles();
+        onDownloadCompleted();
+        return;
+    }
+    
     setStatus(Queued);
 }
 
@@ -511,6 +688,8 @@ void Transfer::start() {
     case Downloading:
     case Uploading:
     case Converting:
+    case Pending:
+    case Moving:
         return;
     default:
         break;
@@ -524,6 +703,7 @@ void Transfer::start() {
     }
     
     setStatus(Connecting);
+    startSubtitles();
     
     if (streamUrl().isEmpty()) {
         listStreams();
@@ -540,6 +720,8 @@ void Transfer::pause() {
     case Completed:
     case Connecting:
     case Converting:
+    case Pending:
+    case Moving:
         return;
     default:
         break;
@@ -549,6 +731,10 @@ void Transfer::pause() {
         m_canceled = false;
         m_reply->abort();
     }
+    else if (segmentsRunning()) {
+        m_canceled = false;
+        abortSegments();
+    }
     else {
         setStatus(Paused);
     }
@@ -559,34 +745,118 @@ void Transfer::cancel() {
     case Canceled:
     case Completed:
     case Converting:
+    case Moving:
         return;
     default:
         break;
     }
     
+    abortSubtitles();
+    
     if ((m_reply) && (m_reply->isRunning())) {
         m_canceled = true;
         m_reply->abort();
     }
+    else if (segmentsRunning()) {
+        m_canceled = true;
+        abortSegments();
+    }
     else {
-        m_file.remove();
-        QDir().rmdir(downloadPath());
+        removeDownloadedFiles();
         setStatus(Canceled);
     }
 }
 
-void Transfer::startDownload(const QUrl &u) {
-    QDir().mkpath(downloadPath());
+QVariantMap Transfer::selectStream(const QVariantList &streams) {
+    if ((convertToAudio()) && (bytesTransferred() == 0)) {
+        QVariantMap audio;
+        QVariantMap lowest;
+        
+        foreach (const QVariant &v, streams) {
+            const QVariantMap stream = v.toMap();
+            
+            if (isAudioStream(stream)) {
+                if ((audio.isEmpty()) || ((!hasAudioExtension(audio)) && (hasAudioExtension(stream)))) {
+                    audio = stream;
+                }
+            }
+            else if ((stream.value("height").toInt() > 0)
+                     && ((lowest.isEmpty()) || (stream.value("height").toInt() < lowest.value("height").toInt()))) {
+                lowest = stream;
+            }
+        }
+        
+        if (!audio.isEmpty()) {
+            if (hasAudioExtension(audio)) {
+                setFileName(fileName().left(fileName().lastIndexOf('.')) + "."
+                            + audio.value("ext").toString().toLower());
+            }
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "Transfer::selectStream: Using audio stream" << audio.value("id");
+#endif
+            setStreamId(audio.value("id").toString());
+            return audio;
+        }
+        
+        if (!lowest.isEmpty()) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "Transfer::selectStream: Using lowest resolution stream" << lowest.value("id");
+#endif
+            setStreamId(lowest.value("id").toString());
+            return lowest;
+        }
+    }
     
-    if (!m_file.open(m_file.exists() ? QFile::Append : QFile::WriteOnly)) {
-        setErrorString(m_file.errorString());
-        setStatus(Failed);
-        return;
+    if (streamId().isEmpty()) {
+        QVariantMap highest;
+        
+        foreach (const QVariant &v, streams) {
+            const QVariantMap stream = v.toMap();
+            
+            if ((highest.isEmpty()) || (stream.value("height").toInt() > highest.value("height").toInt())) {
+                highest = stream;
+            }
+        }
+        
+        if (!highest.isEmpty()) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "Transfer::selectStream: Using highest resolution stream" << highest.value("id");
+#endif
+            setStreamId(highest.value("id").toString());
+        }
+        
+        return highest;
     }
     
-    if (!m_nam) {
-        m_nam = new QNetworkAccessManager(this);
-        m_ownNetworkAccessManager = true;
+    foreach (const QVariant &v, streams) {
+        const QVariantMap stream = v.toMap();
+        
+        if (stream.value("id") == streamId()) {
+            return stream;
+        }
+    }
+    
+    return QVariantMap();
+}
+
+void Transfer::startDownload(const QUrl &u) {
+    m_host = u.host();
+    
+    if (!m_segments.isEmpty()) {
+        startSegmentedDownload(u);
+    }
+    else if ((m_bytesTransferred == 0) && (Settings::instance()->downloadSegments() > 1)) {
+        m_redirects = 0;
+        probeSegments(u);
+    }
+    else {
+        startSingleDownload(u);
+    }
+}
+
+void Transfer::startSingleDownload(const QUrl &u) {
+    if (!openFile()) {
+        return;
     }
     
     QNetworkRequest request(u);
@@ -594,37 +864,29 @@ void Transfer::startDownload(const QUrl &u) {
     if (m_bytesTransferred > 0) {
         request.setRawHeader("Range", "bytes=" + QByteArray::number(m_bytesTransferred) + "-");
 #ifdef CUTETUBE_DEBUG
-        qDebug() << "Transfer::startDownload: Resuming download from" << m_bytesTransferred;
+        qDebug() << "Transfer::startSingleDownload: Resuming download from" << m_bytesTransferred;
 #endif
     }
 #ifdef CUTETUBE_DEBUG
-    qDebug() << "Transfer::startDownload: Downloading" << u;
+    qDebug() << "Transfer::startSingleDownload: Downloading" << u;
 #endif
     setStatus(Downloading);
     
     m_redirects = 0;
     m_reply = m_nam->get(request);
+    m_reply->setReadBufferSize(READ_BUFFER_SIZE);
     connect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(onReplyMetaDataChanged()));
     connect(m_reply, SIGNAL(readyRead()), this, SLOT(onReplyReadyRead()));
     connect(m_reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
 }
 
 void Transfer::followRedirect(const QUrl &u) {
-    QDir().mkpath(downloadPath());
-    
-    if (!m_file.open(m_file.exists() ? QFile::Append : QFile::WriteOnly)) {
-        setErrorString(m_file.errorString());
-        setStatus(Failed);
+    if (!openFile()) {
         return;
     }
     
     m_redirects++;
 
-    if (!m_nam) {
-        m_nam = new QNetworkAccessManager(this);
-        m_ownNetworkAccessManager = true;
-    }
-    
     QNetworkRequest request(u);
     
     if (m_bytesTransferred > 0) {
@@ -637,21 +899,273 @@ void Transfer::followRedirect(const QUrl &u) {
     qDebug() << "Transfer::followRedirect: Downloading" << u;
 #endif
     m_reply = m_nam->get(request);
+    m_reply->setReadBufferSize(READ_BUFFER_SIZE);
     connect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(onReplyMetaDataChanged()));
     connect(m_reply, SIGNAL(readyRead()), this, SLOT(onReplyReadyRead()));
     connect(m_reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
 }
 
+bool Transfer::openFile() {
+    QDir().mkpath(downloadPath());
+    
+    if (!m_writer->open(m_file.fileName())) {
+        setErrorString(m_writer->errorString());
+        setStatus(Failed);
+        return false;
+    }
+    
+    if (size() > 0) {
+        m_writer->preallocate(size());
+    }
+    
+    return true;
+}
+
+qint64 Transfer::bytesAllowed(qint64 bytes) {
+    qint64 allowed = bytes;
+    int delay = 0;
+    
+    foreach (RateLimiter *limiter, m_rateLimiters) {
+        if (limiter->isLimited()) {
+            allowed = qMin(allowed, limiter->available());
+            delay = qMax(delay, limiter->delay());
+        }
+    }
+    
+    if ((allowed < bytes) && (!m_rateTimer.isActive())) {
+        m_rateTimer.start(qMax(RATE_LIMIT_INTERVAL, delay));
+    }
+    
+    return allowed;
+}
+
+void Transfer::consumeBytes(qint64 bytes) {
+    foreach (RateLimiter *limiter, m_rateLimiters) {
+        limiter->consume(bytes);
+    }
+}
+
+void Transfer::readReply(qint64 maxSize) {
+    if (maxSize <= 0) {
+        return;
+    }
+    
+    const qint64 bytes = m_writer->read(m_reply, maxSize);
+    
+    if (bytes < 0) {
+        m_reply->abort();
+        return;
+    }
+    
+    if (bytes == 0) {
+        return;
+    }
+    
+    consumeBytes(bytes);
+    m_bytesTransferred += bytes;
+}
+
+void Transfer::probeSegments(const QUrl &u) {
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Transfer::probeSegments" << u;
+#endif
+    m_reply = m_nam->head(QNetworkRequest(u));
+    connect(m_reply, SIGNAL(finished()), this, SLOT(onProbeReplyFinished()));
+}
+
+bool Transfer::createSegments() {
+    m_segments.clear();
+    
+    if (size() <= 0) {
+        return false;
+    }
+    
+    const int count = int(qMin(qint64(Settings::instance()->downloadSegments()), size() / MIN_DOWNLOAD_SEGMENT_SIZE));
+    
+    if (count < 2) {
+        return false;
+    }
+    
+    const qint64 length = size() / count;
+    
+    for (int i = 0; i < count; i++) {
+        TransferSegment segment;
+        segment.start = i * length;
+        segment.end = (i == count - 1) ? size() - 1 : segment.start + length - 1;
+        m_segments << segment;
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Transfer::createSegments" << count << length;
+#endif
+    return true;
+}
+
+void Transfer::startSegmentedDownload(const QUrl &u) {
+    QDir().mkpath(downloadPath());
+    
+    // Segments are written at their offsets by the writer thread, which extends the file as needed
+    if (!m_writer->open(m_file.fileName(), true)) {
+        setErrorString(m_writer->errorString());
+        setStatus(Failed);
+        return;
+    }
+    
+    m_writer->preallocate(size());
+    m_segmentsErrorString = QString();
+    m_segmentsFallbackUrl = QUrl();
+    setStatus(Downloading);
+    
+    for (int i = 0; i < m_segments.size(); i++) {
+        const TransferSegment &segment = m_segments.at(i);
+        
+        if (segment.start + segment.bytesTransferred <= segment.end) {
+            m_segments[i].redirects = 0;
+            startSegment(i, u);
+        }
+    }
+    
+    if (!segmentsRunning()) {
+        m_writer->close();
+        onDownloadCompleted();
+    }
+}
+
+void Transfer::startSegment(int i, const QUrl &u) {
+    TransferSegment &segment = m_segments[i];
+    QNetworkRequest request(u);
+    request.setRawHeader("Range", "bytes=" + QByteArray::number(segment.start + segment.bytesTransferred) + "-"
+                                  + QByteArray::number(segment.end));
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Transfer::startSegment" << i << request.rawHeader("Range") << u;
+#endif
+    segment.reply = m_nam->get(request);
+    segment.reply->setReadBufferSize(READ_BUFFER_SIZE);
+    connect(segment.reply, SIGNAL(readyRead()), this, SLOT(onSegmentReplyReadyRead()));
+    connect(segment.reply, SIGNAL(finished()), this, SLOT(onSegmentReplyFinished()));
+}
+
+void Transfer::readSegment(int i, qint64 maxSize) {
+    QNetworkReply *reply = m_segments.at(i).reply;
+    
+    if ((!reply) || (maxSize <= 0)) {
+        return;
+    }
+    
+    switch (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()) {
+    case 206:
+        break;
+    case 200:
+        // The range was ignored, so the download is restarted in one piece once all segments have stopped
+        if (m_segmentsFallbackUrl.isEmpty()) {
+            m_segmentsFallbackUrl = reply->url();
+        }
+        
+        abortSegments();
+        return;
+    default:
+        return;
+    }
+    
+    TransferSegment &segment = m_segments[i];
+    const QByteArray data = reply->read(qMin(maxSize, segment.end - segment.start - segment.bytesTransferred + 1));
+    
+    if (data.isEmpty()) {
+        return;
+    }
+    
+    if (!m_writer->write(segment.start + segment.bytesTransferred, data)) {
+        if (m_segmentsErrorString.isEmpty()) {
+            m_segmentsErrorString = m_writer->errorString();
+        }
+        
+        abortSegments();
+        return;
+    }
+    
+    consumeBytes(data.size());
+    segment.bytesTransferred += data.size();
+    m_bytesTransferred += data.size();
+    
+    if ((segment.start + segment.bytesTransferred > segment.end) && (reply->isRunning())) {
+        reply->abort();
+    }
+}
+
+void Transfer::abortSegments() {
+    for (int i = 0; i < m_segments.size(); i++) {
+        if (QNetworkReply *reply = m_segments.at(i).reply) {
+            reply->abort();
+        }
+    }
+}
+
+int Transfer::segmentIndex(QNetworkReply *reply) const {
+    for (int i = 0; i < m_segments.size(); i++) {
+        if (m_segments.at(i).reply == reply) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+bool Transfer::segmentsRunning() const {
+    foreach (const TransferSegment &segment, m_segments) {
+        if ((segment.reply) && (segment.reply->isRunning())) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool Transfer::segmentsComplete() const {
+    foreach (const TransferSegment &segment, m_segments) {
+        if (segment.start + segment.bytesTransferred <= segment.end) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+QString Transfer::subtitlesFileName() const {
+    return m_file.fileName().left(m_file.fileName().lastIndexOf('.')) + ".srt";
+}
+
+void Transfer::startSubtitles() {
+    if ((!downloadSubtitles()) || (m_subtitlesRunning) || (QFile::exists(subtitlesFileName()))) {
+        return;
+    }
+    
+    m_subtitlesRunning = true;
+    listSubtitles();
+}
+
+void Transfer::abortSubtitles() {
+    if ((m_subtitlesReply) && (m_subtitlesReply->isRunning())) {
+        m_subtitlesReply->abort();
+    }
+}
+
 void Transfer::startSubtitlesDownload(const QUrl &u) {    
-    if (!m_nam) {
-        m_nam = new QNetworkAccessManager(this);
-        m_ownNetworkAccessManager = true;
+    if (status() == Canceled) {
+        finishSubtitlesDownload();
+        return;
     }
 #ifdef CUTETUBE_DEBUG
     qDebug() << "Transfer::startSubtitlesDownload: Downloading" << u;
 #endif
-    m_reply = m_nam->get(QNetworkRequest(u));
-    connect(m_reply, SIGNAL(finished()), this, SLOT(onSubtitlesReplyFinished()));
+    m_subtitlesReply = m_nam->get(QNetworkRequest(u));
+    connect(m_subtitlesReply, SIGNAL(finished()), this, SLOT(onSubtitlesReplyFinished()));
+}
+
+void Transfer::finishSubtitlesDownload() {
+    m_subtitlesRunning = false;
+    
+    if (status() == Pending) {
+        PostProcessor::instance()->enqueue(this);
+    }
 }
 
 void Transfer::startAudioConversion() {
@@ -661,10 +1175,13 @@ void Transfer::startAudioConversion() {
         connect(m_audioConverter, SIGNAL(error()), this, SLOT(onAudioConversionError()));
     }
     
+    setStatus(Converting);
     m_audioConverter->start(m_file.fileName(), downloadPath());
 }
 
 void Transfer::moveDownloadedFiles() {
+    setStatus(Moving);
+    
     QDir destDir(Settings::instance()->downloadPath(category()));
     
     if (!destDir.mkpath(destDir.path())) {
@@ -701,6 +1218,13 @@ void Transfer::moveDownloadedFiles() {
     setStatus(Completed);
 }
 
+void Transfer::removeDownloadedFiles() {
+    m_segments.clear();
+    m_file.remove();
+    QFile::remove(subtitlesFileName());
+    QDir().rmdir(downloadPath());
+}
+
 void Transfer::onReplyMetaDataChanged() {
     if (size() > 0) {
         return;
@@ -727,23 +1251,11 @@ void Transfer::onReplyMetaDataChanged() {
     }
     
     setSize(s);
+    m_writer->preallocate(s);
 }
 
 void Transfer::onReplyReadyRead() {
-    m_bytesTransferred += m_reply->bytesAvailable();
-#ifdef SYMBIAN_OS
-    m_buffer += m_reply->readAll();
-
-    if (m_buffer.size() >= BUFFER_SIZE) {
-        m_file.write(m_buffer);
-        m_buffer.clear();
-    }
-#else
-    m_file.write(m_reply->readAll());
-#endif
-    if (m_size > 0) {
-        setProgress(m_bytesTransferred * 100 / m_size);
-    }
+    readReply(bytesAllowed(m_reply->bytesAvailable()));
 }
 
 void Transfer::onReplyFinished() {
@@ -754,16 +1266,20 @@ void Transfer::onReplyFinished() {
     if (redirect.isNull()) {
         redirect = m_reply->header(QNetworkRequest::LocationHeader);        
     }
-#ifdef SYMBIAN_OS
-    if (!m_buffer.isEmpty()) {
-        m_file.write(m_buffer);
-        m_buffer.clear();
+    
+    if ((error == QNetworkReply::NoError) && (redirect.isNull())) {
+        readReply(m_reply->bytesAvailable());
     }
-#endif
-    m_file.close();
+    const bool written = m_writer->close();
     m_reply->deleteLater();
     m_reply = 0;
     
+    if (!written) {
+        setErrorString(m_writer->errorString());
+        setStatus(Failed);
+        return;
+    }
+    
     if (!redirect.isNull()) {
         if (m_redirects < MAX_REDIRECTS) {
             followRedirect(redirect.toString());
@@ -783,8 +1299,7 @@ void Transfer::onReplyFinished() {
         setErrorString(QString());
         
         if (m_canceled) {
-            m_file.remove();
-            QDir().rmdir(downloadPath());
+            removeDownloadedFiles();
             setStatus(Canceled);
         }
         else {
@@ -798,53 +1313,241 @@ void Transfer::onReplyFinished() {
         return;
     }
     
-    if (downloadSubtitles()) {
-        listSubtitles();
+    onDownloadCompleted();
+}
+
+void Transfer::onProbeReplyFinished() {
+    const QUrl url = m_reply->url();
+    const QNetworkReply::NetworkError error = m_reply->error();
+#ifdef CUTETUBE_DEBUG
+    const QString errorString = m_reply->errorString();
+#endif
+    const bool acceptRanges = (m_reply->rawHeader("Accept-Ranges").trimmed().toLower() == "bytes");
+    qint64 s = m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+    
+    if (s <= 0) {
+        s = m_reply->rawHeader("Content-Length").toLongLong();
+    }
+    
+    QVariant redirect = m_reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+
+    if (redirect.isNull()) {
+        redirect = m_reply->header(QNetworkRequest::LocationHeader);        
     }
-    else if (convertToAudio()) {
-        startAudioConversion();
+    
+    m_reply->deleteLater();
+    m_reply = 0;
+    
+    if (!redirect.isNull()) {
+        if (m_redirects < MAX_REDIRECTS) {
+            m_redirects++;
+            probeSegments(url.resolved(redirect.toUrl()));
+        }
+        else {
+            setErrorString(tr("Maximum redirects reached"));
+            setStatus(Failed);
+        }
+        
+        return;
+    }
+    
+    switch (error) {
+    case QNetworkReply::NoError:
+        break;
+    case QNetworkReply::OperationCanceledError:
+        setErrorString(QString());
+        
+        if (m_canceled) {
+            removeDownloadedFiles();
+            setStatus(Canceled);
+        }
+        else {
+            setStatus(Paused);
+        }
+        
+        return;
+    default:
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "Transfer::onProbeReplyFinished: Error" << errorString;
+#endif
+        startSingleDownload(url);
+        return;
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Transfer::onProbeReplyFinished" << acceptRanges << s;
+#endif
+    if (s > 0) {
+        setSize(s);
+    }
+    
+    if ((acceptRanges) && (createSegments())) {
+        startSegmentedDownload(url);
     }
     else {
-        moveDownloadedFiles();
+        startSingleDownload(url);
     }
 }
 
-void Transfer::onSubtitlesReplyFinished() {
-    switch (m_reply->error()) {
+void Transfer::onSegmentReplyReadyRead() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    const int i = segmentIndex(reply);
+    
+    if (i != -1) {
+        readSegment(i, bytesAllowed(reply->bytesAvailable()));
+    }
+}
+
+void Transfer::onSegmentReplyFinished() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    const int i = segmentIndex(reply);
+    
+    if (i == -1) {
+        return;
+    }
+    
+    QVariant redirect = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+
+    if (redirect.isNull()) {
+        redirect = reply->header(QNetworkRequest::LocationHeader);        
+    }
+    
+    if ((reply->error() == QNetworkReply::NoError) && (redirect.isNull())) {
+        readSegment(i, reply->bytesAvailable());
+    }
+    
+    m_segments[i].reply = 0;
+    reply->deleteLater();
+    
+    switch (reply->error()) {
     case QNetworkReply::NoError:
+        if (!redirect.isNull()) {
+            if (m_segments.at(i).redirects < MAX_REDIRECTS) {
+                m_segments[i].redirects++;
+                startSegment(i, reply->url().resolved(redirect.toUrl()));
+                return;
+            }
+            
+            if (m_segmentsErrorString.isEmpty()) {
+                m_segmentsErrorString = tr("Maximum redirects reached");
+            }
+            
+            abortSegments();
+        }
+        else if (m_segments.at(i).start + m_segments.at(i).bytesTransferred <= m_segments.at(i).end) {
+            if (m_segmentsErrorString.isEmpty()) {
+                m_segmentsErrorString = tr("Connection closed before segment was completed");
+            }
+            
+            abortSegments();
+        }
+        
+        break;
     case QNetworkReply::OperationCanceledError:
         break;
     default:
+        if (m_segmentsErrorString.isEmpty()) {
+            m_segmentsErrorString = reply->errorString();
+        }
+        
+        abortSegments();
+        break;
+    }
+    
+    if ((segmentsRunning()) || (status() != Downloading)) {
+        return;
+    }
+    
+    if ((!m_writer->close()) && (m_segmentsErrorString.isEmpty())) {
+        m_segmentsErrorString = m_writer->errorString();
+    }
+    
+    if ((!m_segmentsFallbackUrl.isEmpty()) && (!m_canceled)) {
 #ifdef CUTETUBE_DEBUG
-        qDebug() << "Transfer::onSubtitlesReplyFinished: Error" << m_reply->errorString();
+        qDebug() << "Transfer::onSegmentReplyFinished: Server does not support segmented downloads";
 #endif
-        if (convertToAudio()) {
-            startAudioConversion();
+        const QUrl url = m_segmentsFallbackUrl;
+        m_segmentsFallbackUrl = QUrl();
+        m_segmentsErrorString = QString();
+        m_segments.clear();
+        m_file.remove();
+        m_bytesTransferred = 0;
+        setProgress(0);
+        startSingleDownload(url);
+    }
+    else if (!m_segmentsErrorString.isEmpty()) {
+        setErrorString(m_segmentsErrorString);
+        setStatus(Failed);
+    }
+    else if (segmentsComplete()) {
+        onDownloadCompleted();
+    }
+    else if (m_canceled) {
+        setErrorString(QString());
+        removeDownloadedFiles();
+        setStatus(Canceled);
+    }
+    else {
+        setErrorString(QString());
+        setStatus(Paused);
+    }
+}
+
+void Transfer::onRateTimerTimeout() {
+    if (status() != Downloading) {
+        return;
+    }
+    
+    if ((m_reply) && (m_writer->isOpen())) {
+        readReply(bytesAllowed(m_reply->bytesAvailable()));
+    }
+    
+    for (int i = 0; i < m_segments.size(); i++) {
+        if (QNetworkReply *reply = m_segments.at(i).reply) {
+            readSegment(i, bytesAllowed(reply->bytesAvailable()));
         }
-        else {
-            moveDownloadedFiles();
+    }
+}
+
+void Transfer::onDownloadCompleted() {
+    setStatus(Pending);
+    
+    if (!m_subtitlesRunning) {
+        PostProcessor::instance()->enqueue(this);
+    }
+}
+
+void Transfer::onSubtitlesReplyFinished() {
+    const QNetworkReply::NetworkError error = m_subtitlesReply->error();
+    
+    switch (error) {
+    case QNetworkReply::NoError: {
+        QDir().mkpath(downloadPath());
+        QFile file(subtitlesFileName());
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "Transfer::onSubtitlesReplyFinished: Writing subtitles to" << file.fileName();
+#endif
+        if (file.open(QFile::WriteOnly)) {
+            file.write(m_subtitlesReply->readAll());
+            file.close();
         }
         
-        return;
+        break;
     }
-    
-    QFile file(m_file.fileName().left(m_file.fileName().lastIndexOf('.')) + ".srt");
+    default:
 #ifdef CUTETUBE_DEBUG
-    qDebug() << "Transfer::onSubtitlesReplyFinished: Writing subtitles to" << file.fileName();
+        qDebug() << "Transfer::onSubtitlesReplyFinished: Error" << m_subtitlesReply->errorString();
 #endif
-    if (file.open(QFile::WriteOnly)) {
-        file.write(m_reply->readAll());
-        file.close();
+        break;
     }
     
-    m_reply->deleteLater();
-    m_reply = 0;
+    m_subtitlesReply->deleteLater();
+    m_subtitlesReply = 0;
     
-    if (convertToAudio()) {
-        startAudioConversion();
+    if (error == QNetworkReply::OperationCanceledError) {
+        m_subtitlesRunning = false;
     }
     else {
-        moveDownloadedFiles();
+        finishSubtitlesDownload();
     }
 }
 
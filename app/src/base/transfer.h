@@ -17,9 +17,11 @@
 #ifndef TRANSFER_H
 #define TRANSFER_H
 
+#include <QElapsedTimer>
 #include <QString>
 #include <QUrl>
 #include <QFile>
+#include <QTimer>
 #include <QVariantList>
 #include <qplatformdefs.h>
 
@@ -31,8 +33,27 @@ namespace TransferUI {
 #endif
 
 class AudioConverter;
+class FileWriter;
 class QNetworkAccessManager;
 class QNetworkReply;
+class RateLimiter;
+
+struct TransferSegment {
+    TransferSegment() :
+        start(0),
+        end(0),
+        bytesTransferred(0),
+        redirects(0),
+        reply(0)
+    {
+    }
+    
+    qint64 start;
+    qint64 end;
+    qint64 bytesTransferred;
+    int redirects;
+    QNetworkReply *reply;
+};
 
 class Transfer : public QObject
 {
@@ -47,6 +68,7 @@ class Transfer : public QObject
     Q_PROPERTY(QString subtitlesLanguage READ subtitlesLanguage WRITE setSubtitlesLanguage
                NOTIFY subtitlesLanguageChanged)
     Q_PROPERTY(QString errorString READ errorString NOTIFY statusChanged)
+    Q_PROPERTY(int eta READ eta NOTIFY progressChanged)
     Q_PROPERTY(QString fileName READ fileName WRITE setFileName NOTIFY fileNameChanged)
     Q_PROPERTY(QString id READ id WRITE setId NOTIFY idChanged)
     Q_PROPERTY(Priority priority READ priority WRITE setPriority NOTIFY priorityChanged)
@@ -55,6 +77,7 @@ class Transfer : public QObject
     Q_PROPERTY(QString resourceId READ resourceId WRITE setResourceId NOTIFY resourceIdChanged)
     Q_PROPERTY(QString service READ service NOTIFY serviceChanged)
     Q_PROPERTY(qint64 size READ size WRITE setSize NOTIFY sizeChanged)
+    Q_PROPERTY(qint64 speed READ speed NOTIFY progressChanged)
     Q_PROPERTY(Status status READ status NOTIFY statusChanged)
     Q_PROPERTY(QString statusString READ statusString NOTIFY statusChanged)
     Q_PROPERTY(QString streamId READ streamId WRITE setStreamId NOTIFY streamIdChanged)
@@ -82,6 +105,8 @@ public:
         Downloading,
         Uploading,
         Converting,
+        Pending,
+        Moving,
         Unknown
     };
     
@@ -95,6 +120,8 @@ public:
     
     void setNetworkAccessManager(QNetworkAccessManager *manager);
     
+    void setRateLimiters(const QList<RateLimiter*> &limiters);
+    
     qint64 bytesTransferred() const;
     
     bool canConvertToAudio() const;
@@ -117,6 +144,8 @@ public:
     QString fileName() const;
     void setFileName(const QString &fn);
     
+    QString host() const;
+    
     QString id() const;
     void setId(const QString &i);
         
@@ -125,15 +154,22 @@ public:
     QString priorityString() const;
     
     int progress() const;
+    bool updateProgress();
     
     QString resourceId() const;
     void setResourceId(const QString &ri);
     
+    QVariantList segments() const;
+    void setSegments(const QVariantList &s);
+    
     QString service() const;
     
     qint64 size() const;
     void setSize(qint64 s);
     
+    qint64 speed() const;
+    int eta() const;
+    
     Status status() const;
     QString statusString() const;
     
@@ -151,6 +187,8 @@ public:
     
     QUrl url() const;
     
+    void process();
+    
 public Q_SLOTS:
     void queue();
     void start();
@@ -169,19 +207,53 @@ protected:
         
     void setStatus(Status s);
         
+    QVariantMap selectStream(const QVariantList &streams);
+    
     void startDownload(const QUrl &u);
     void followRedirect(const QUrl &u);
         
     void startSubtitlesDownload(const QUrl &u);
+    void finishSubtitlesDownload();
     
     void startAudioConversion();
     
     void moveDownloadedFiles();    
     
+private:
+    QString subtitlesFileName() const;
+    void startSubtitles();
+    void abortSubtitles();
+    
+    void removeDownloadedFiles();
+    
+    void startSingleDownload(const QUrl &u);
+    
+    bool openFile();
+    
+    qint64 bytesAllowed(qint64 bytes);
+    void consumeBytes(qint64 bytes);
+    void readReply(qint64 maxSize);
+    
+    void probeSegments(const QUrl &u);
+    bool createSegments();
+    void startSegmentedDownload(const QUrl &u);
+    void startSegment(int i, const QUrl &u);
+    void readSegment(int i, qint64 maxSize);
+    void abortSegments();
+    int segmentIndex(QNetworkReply *reply) const;
+    bool segmentsRunning() const;
+    bool segmentsComplete() const;
+    
+    void onDownloadCompleted();
+    
 private Q_SLOTS:
     void onReplyMetaDataChanged();
     void onReplyReadyRead();
     void onReplyFinished();
+    void onProbeReplyFinished();
+    void onSegmentReplyReadyRead();
+    void onSegmentReplyFinished();
+    void onRateTimerTimeout();
     void onSubtitlesReplyFinished();
     void onAudioConversionFinished();
     void onAudioConversionError();
@@ -216,10 +288,14 @@ private:
     
     QNetworkAccessManager *m_nam;
     QNetworkReply *m_reply;
+    QNetworkReply *m_subtitlesReply;
         
     QFile m_file;
+    FileWriter *m_writer;
+    
+    QList<RateLimiter*> m_rateLimiters;
+    QTimer m_rateTimer;
     
-    bool m_ownNetworkAccessManager;
     bool m_canceled;
     
     mutable bool m_canConvertToAudio;
@@ -231,12 +307,15 @@ private:
     QString m_downloadPath;
     
     bool m_downloadSubtitles;
+    bool m_subtitlesRunning;
     QString m_subtitlesLanguage;
     
     QString m_errorString;
     
     QString m_fileName;
     
+    QString m_host;
+    
     QString m_id;
     
     Priority m_priority;
@@ -245,10 +324,17 @@ private:
     
     QString m_resourceId;
     
+    QList<TransferSegment> m_segments;
+    QString m_segmentsErrorString;
+    QUrl m_segmentsFallbackUrl;
+    
     QString m_service;
     
     qint64 m_size;
     qint64 m_bytesTransferred;
+    qint64 m_lastBytesTransferred;
+    QElapsedTimer m_progressTimer;
+    qint64 m_speed;
     
     int m_redirects;
     
@@ -261,9 +347,6 @@ private:
     QString m_title;
     
     TransferType m_transferType;
-#ifdef SYMBIAN_OS
-    QByteArray m_buffer;
-#endif
 };
     
 #endif // TRANSFER_H
@@ -19,31 +19,37 @@
 #include "utils.h"
 
 TransferModel::TransferModel(QObject *parent) :
-    QAbstractListModel(parent)
+    RoleListModel(parent)
 {
-    m_roles[BytesTransferredRole] = "bytesTransferred";
-    m_roles[CanConvertToAudioRole] = "canConvertToAudio";
-    m_roles[ConvertToAudioRole] = "convertToAudio";
-    m_roles[CategoryRole] = "category";
-    m_roles[DownloadPathRole] = "downloadPath";
-    m_roles[ErrorStringRole] = "errorString";
-    m_roles[FileNameRole] = "fileName";
-    m_roles[IdRole] = "id";
-    m_roles[PriorityRole] = "priority";
-    m_roles[PriorityStringRole] = "priorityString";
-    m_roles[ProgressRole] = "progress";
-    m_roles[ResourceIdRole] = "resourceId";
-    m_roles[ServiceRole] = "service";
-    m_roles[SizeRole] = "size";
-    m_roles[StatusRole] = "status";
-    m_roles[StatusStringRole] = "statusString";
-    m_roles[StreamIdRole] = "streamId";
-    m_roles[TitleRole] = "title";
-    m_roles[TransferTypeRole] = "transferType";
-    m_roles[UrlRole] = "url";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<Transfer> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BytesTransferredRole, "bytesTransferred", &Transfer::bytesTransferred);
+        roles.insert(CanConvertToAudioRole, "canConvertToAudio", &Transfer::canConvertToAudio);
+        roles.insert(ConvertToAudioRole, "convertToAudio", &Transfer::convertToAudio);
+        roles.insert(CategoryRole, "category", &Transfer::category);
+        roles.insert(DownloadPathRole, "downloadPath", &Transfer::downloadPath);
+        roles.insert(ErrorStringRole, "errorString", &Transfer::errorString);
+        roles.insert(EtaRole, "eta", &Transfer::eta);
+        roles.insert(FileNameRole, "fileName", &Transfer::fileName);
+        roles.insert(IdRole, "id", &Transfer::id);
+        roles.insert(PriorityRole, "priority", &Transfer::priority);
+        roles.insert(PriorityStringRole, "priorityString", &Transfer::priorityString);
+        roles.insert(ProgressRole, "progress", &Transfer::progress);
+        roles.insert(ResourceIdRole, "resourceId", &Transfer::resourceId);
+        roles.insert(ServiceRole, "service", &Transfer::service);
+        roles.insert(SizeRole, "size", &Transfer::size);
+        roles.insert(SpeedRole, "speed", &Transfer::speed);
+        roles.insert(StatusRole, "status", &Transfer::status);
+        roles.insert(StatusStringRole, "statusString", &Transfer::statusString);
+        roles.insert(StreamIdRole, "streamId", &Transfer::streamId);
+        roles.insert(TitleRole, "title", &Transfer::title);
+        roles.insert(TransferTypeRole, "transferType", &Transfer::transferType);
+        roles.insert(UrlRole, "url", &Transfer::url);
+    }
+    
+    setRoleTable(&roles);
+    
     for (int i = 0; i < Transfers::instance()->count(); i++) {
         if (Transfer *transfer = Transfers::instance()->get(i)) {
             onTransferAdded(transfer);
@@ -52,15 +58,11 @@ TransferModel::TransferModel(QObject *parent) :
     
     connect(Transfers::instance(), SIGNAL(countChanged(int)), this, SLOT(onCountChanged(int)));
     connect(Transfers::instance(), SIGNAL(transferAdded(Transfer*)), this, SLOT(onTransferAdded(Transfer*)));
+    connect(Transfers::instance(), SIGNAL(progressChanged(QList<Transfer*>)),
+            this, SLOT(onTransfersProgressChanged(QList<Transfer*>)));
     emit countChanged(rowCount());
 }
 
-#if QT_VERSION >= 0x050000
-QHash<int, QByteArray> TransferModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int TransferModel::rowCount(const QModelIndex &) const {
     return Transfers::instance()->count();
 }
@@ -101,6 +103,13 @@ QVariant TransferModel::data(const QModelIndex &index, int role) const {
             case 2:
                 return transfer->priorityString();
             case 3:
+                if (transfer->speed() > 0) {
+                    return QString("%1 of %2 (%3%) - %4/s").arg(Utils::formatBytes(transfer->bytesTransferred()))
+                                                          .arg(Utils::formatBytes(transfer->size()))
+                                                          .arg(transfer->progress())
+                                                          .arg(Utils::formatBytes(transfer->speed()));
+                }
+                
                 return QString("%1 of %2 (%3%)").arg(Utils::formatBytes(transfer->bytesTransferred()))
                                                 .arg(Utils::formatBytes(transfer->size()))
                                                 .arg(transfer->progress());
@@ -111,31 +120,16 @@ QVariant TransferModel::data(const QModelIndex &index, int role) const {
             }
         }
         else {
-            return transfer->property(m_roles[role]);
+            return RoleListModel::data(index, role);
         }
     }
     
     return QVariant();
 }
 
-QMap<int, QVariant> TransferModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (Transfer *transfer = Transfers::instance()->get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = transfer->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
 bool TransferModel::setData(const QModelIndex &index, const QVariant &value, int role) {
     if (Transfer *transfer = Transfers::instance()->get(index.row())) {
-        return transfer->setProperty(m_roles[role], value);
+        return transfer->setProperty(roleTable()->names().value(role), value);
     }
     
     return false;
@@ -157,26 +151,6 @@ bool TransferModel::setItemData(const QModelIndex &index, const QMap<int, QVaria
     return ok;
 }
 
-QVariant TransferModel::data(int row, const QByteArray &role) const {
-    if (Transfer *transfer = Transfers::instance()->get(row)) {
-        return transfer->property(role);
-    }
-
-    return QVariant();
-}
-
-QVariantMap TransferModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (Transfer *transfer = Transfers::instance()->get(row)) {
-        foreach (QByteArray value, m_roles.values()) {
-            map[value] = transfer->property(value);
-        }
-    }
-    
-    return map;
-}
-
 bool TransferModel::setData(int row, const QVariant &value, const QByteArray &role) {
     if (Transfer *transfer = Transfers::instance()->get(row)) {
         return transfer->setProperty(role, value);
@@ -211,6 +185,10 @@ int TransferModel::match(const QByteArray &role, const QVariant &value) const {
     return -1;
 }
 
+QObject* TransferModel::get(int row) const {
+    return Transfers::instance()->get(row);
+}
+
 int TransferModel::indexOf(Transfer *transfer) const {
     for (int i = 0; i < Transfers::instance()->count(); i++) {
         if (Transfers::instance()->get(i) == transfer) {
@@ -231,7 +209,6 @@ void TransferModel::onTransferAdded(Transfer *transfer) {
     connect(transfer, SIGNAL(titleChanged()), this, SLOT(onTransferTitleChanged()));
     connect(transfer, SIGNAL(categoryChanged()), this, SLOT(onTransferCategoryChanged()));
     connect(transfer, SIGNAL(priorityChanged()), this, SLOT(onTransferPriorityChanged()));
-    connect(transfer, SIGNAL(progressChanged()), this, SLOT(onTransferProgressChanged()));
     connect(transfer, SIGNAL(sizeChanged()), this, SLOT(onTransferSizeChanged()));
     connect(transfer, SIGNAL(statusChanged()), this, SLOT(onTransferStatusChanged()));
 }
@@ -259,8 +236,22 @@ void TransferModel::onTransferPriorityChanged() {
     onTransferDataChanged(2);
 }
 
-void TransferModel::onTransferProgressChanged() {
-    onTransferDataChanged(3);
+void TransferModel::onTransfersProgressChanged(const QList<Transfer*> &transfers) {
+    int first = -1;
+    int last = -1;
+    
+    foreach (Transfer *transfer, transfers) {
+        const int row = indexOf(transfer);
+        
+        if (row != -1) {
+            first = (first == -1) ? row : qMin(first, row);
+            last = qMax(last, row);
+        }
+    }
+    
+    if (first != -1) {
+        emit dataChanged(index(first, 3), index(last, 3));
+    }
 }
 
 void TransferModel::onTransferSizeChanged() {
@@ -268,5 +259,11 @@ void TransferModel::onTransferSizeChanged() {
 }
 
 void TransferModel::onTransferStatusChanged() {
-    onTransferDataChanged(4);
+    if (Transfer *transfer = qobject_cast<Transfer*>(sender())) {
+        const int row = indexOf(transfer);
+        
+        if (row != -1) {
+            emit dataChanged(index(row, 3), index(row, 4));
+        }
+    }
 }
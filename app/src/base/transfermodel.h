@@ -17,11 +17,11 @@
 #ifndef TRANSFERMODEL_H
 #define TRANSFERMODEL_H
 
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
 class Transfer;
 
-class TransferModel : public QAbstractListModel
+class TransferModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -35,6 +35,7 @@ public:
         CategoryRole,
         DownloadPathRole,
         ErrorStringRole,
+        EtaRole,
         FileNameRole,
         IdRole,
         PriorityRole,
@@ -43,6 +44,7 @@ public:
         ResourceIdRole,
         ServiceRole,
         SizeRole,
+        SpeedRole,
         StatusRole,
         StatusStringRole,
         StreamIdRole,
@@ -53,27 +55,23 @@ public:
     
     explicit TransferModel(QObject *parent = 0);
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
-
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     int columnCount(const QModelIndex &parent = QModelIndex()) const;
     
     QVariant headerData(int section, Qt::Orientation orientation = Qt::Horizontal, int role = Qt::DisplayRole) const;
+    using RoleListModel::data;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
     bool setData(const QModelIndex &index, const QVariant &value, int role);
     bool setItemData(const QModelIndex &index, const QMap<int, QVariant> &roles);
     
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
     Q_INVOKABLE bool setData(int row, const QVariant &value, const QByteArray &role);
     Q_INVOKABLE bool setItemData(int row, const QVariantMap &roles);
     
     Q_INVOKABLE int match(const QByteArray &role, const QVariant &value) const;
     
 private:
+    QObject* get(int row) const;
+    
     int indexOf(Transfer *transfer) const;
     
 private Q_SLOTS:
@@ -83,15 +81,12 @@ private Q_SLOTS:
     void onTransferTitleChanged();
     void onTransferCategoryChanged();
     void onTransferPriorityChanged();
-    void onTransferProgressChanged();
+    void onTransfersProgressChanged(const QList<Transfer*> &transfers);
     void onTransferSizeChanged();
     void onTransferStatusChanged();
     
 Q_SIGNALS:
     void countChanged(int c);
-    
-private:
-    QHash<int, QByteArray> m_roles;
 };
 
 #endif // TRANSFERMODEL_H
@@ -16,17 +16,27 @@
 
 #include "transfers.h"
 #include "dailymotiontransfer.h"
+#include "database.h"
 #include "definitions.h"
+#include "json.h"
+#include "jsonparser.h"
+#include "networkaccessmanager.h"
 #include "plugintransfer.h"
 #include "resources.h"
 #include "settings.h"
 #include "vimeotransfer.h"
 #include "youtubetransfer.h"
 #include <QCoreApplication>
-#include <QNetworkAccessManager>
 #include <QSettings>
 #include <QDateTime>
 
+static const int STORE_INTERVAL = 5000;
+static const int SAMPLE_INTERVAL = 3000;
+static const int PROGRESS_INTERVAL = 250;
+static const int MAX_THROUGHPUT_SAMPLES = 20;
+static const double CONCURRENCY_INCREASE_THRESHOLD = 1.1;
+static const double CONCURRENCY_DECREASE_THRESHOLD = 0.75;
+
 Transfers* Transfers::self = 0;
 
 inline static Transfer* createTransfer(const QString &service, QObject *parent = 0) {
@@ -46,22 +56,42 @@ inline static Transfer* createTransfer(const QString &service, QObject *parent =
 
 Transfers::Transfers(QObject *parent) :
     QObject(parent),
-    m_nam(new QNetworkAccessManager(this))
+    m_nam(NetworkAccessManager::instance()),
+    m_queued(Transfer::LowPriority + 1),
+    m_concurrency(Settings::instance()->maximumConcurrentTransfers()),
+    m_throughput(0),
+    m_sampled(0),
+    m_rateLimiter(Settings::instance()->maximumDownloadSpeed() * 1024)
 {
     if (!self) {
         self = this;
     }
     
     m_queueTimer.setSingleShot(true);
-    m_queueTimer.setInterval(1000);
+    m_queueTimer.setInterval(0);
+    m_storeTimer.setSingleShot(true);
+    m_storeTimer.setInterval(STORE_INTERVAL);
+    m_sampleTimer.setInterval(SAMPLE_INTERVAL);
+    m_progressTimer.setInterval(PROGRESS_INTERVAL);
     
     connect(&m_queueTimer, SIGNAL(timeout()), this, SLOT(startNextTransfers()));
+    connect(&m_storeTimer, SIGNAL(timeout()), this, SLOT(storeTransfers()));
+    connect(&m_sampleTimer, SIGNAL(timeout()), this, SLOT(onSampleTimerTimeout()));
+    connect(&m_progressTimer, SIGNAL(timeout()), this, SLOT(onProgressTimerTimeout()));
+    connect(Settings::instance(), SIGNAL(adaptiveConcurrencyChanged()), this, SLOT(onAdaptiveConcurrencyChanged()));
     connect(Settings::instance(), SIGNAL(maximumConcurrentTransfersChanged()),
             this, SLOT(onMaximumConcurrentTransfersChanged()));
+    connect(Settings::instance(), SIGNAL(maximumDownloadSpeedChanged()), this, SLOT(onMaximumDownloadSpeedChanged()));
     connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(storeTransfers()));
+    
+    if (Settings::instance()->adaptiveConcurrency()) {
+        m_sampleTimer.start();
+    }
 }
 
 Transfers::~Transfers() {
+    qDeleteAll(m_rateLimiters);
+    
     if (self == this) {
         self = 0;
     }
@@ -75,13 +105,42 @@ int Transfers::active() const {
     return m_active.size();
 }
 
+int Transfers::concurrency() const {
+    return Settings::instance()->adaptiveConcurrency() ? m_concurrency
+                                                        : Settings::instance()->maximumConcurrentTransfers();
+}
+
+void Transfers::setConcurrency(int c) {
+    c = qBound(1, c, MAX_ADAPTIVE_CONCURRENT_TRANSFERS);
+    
+    if (c != m_concurrency) {
+        m_concurrency = c;
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "Transfers::setConcurrency" << c;
+#endif
+        emit concurrencyChanged(c);
+        
+        if (active() < c) {
+            m_queueTimer.start();
+        }
+    }
+}
+
 int Transfers::count() const {
     return m_transfers.size();
 }
 
-void Transfers::addDownloadTransfer(const QString &service, const QString &resourceId, const QString &streamId,
-                                    const QUrl &streamUrl, const QString &title, const QString &category,
-                                    const QString &subtitlesLanguage, bool convertToAudio) {
+qint64 Transfers::throughput() const {
+    return m_throughput;
+}
+
+QVariantList Transfers::throughputSamples() const {
+    return m_samples;
+}
+
+Transfer* Transfers::addDownloadTransfer(const QString &service, const QString &resourceId, const QString &streamId,
+                                         const QUrl &streamUrl, const QString &title, const QString &category,
+                                         const QString &subtitlesLanguage, bool convertToAudio) {
     Transfer *transfer = createTransfer(service, this);
     transfer->setNetworkAccessManager(m_nam);
     transfer->setId(QByteArray(QByteArray::number(QDateTime::currentMSecsSinceEpoch()) + "#"
@@ -100,15 +159,9 @@ void Transfers::addDownloadTransfer(const QString &service, const QString &resou
         transfer->setSubtitlesLanguage(subtitlesLanguage);
     }
     
-    connect(transfer, SIGNAL(statusChanged()), this, SLOT(onTransferStatusChanged()));
-    
-    m_transfers << transfer;
-    emit countChanged(count());
-    emit transferAdded(transfer);
-    
-    if (Settings::instance()->startTransfersAutomatically()) {
-        transfer->queue();
-    }
+    storeTransfer(transfer);
+    addTransfer(transfer);
+    return transfer;
 }
 
 Transfer* Transfers::get(int i) const {
@@ -120,13 +173,7 @@ Transfer* Transfers::get(int i) const {
 }
 
 Transfer* Transfers::get(const QString &id) const {
-    foreach (Transfer *transfer, m_transfers) {
-        if (transfer->id() == id) {
-            return transfer;
-        }
-    }
-    
-    return 0;
+    return m_ids.value(id);
 }
 
 bool Transfers::start() {
@@ -173,29 +220,117 @@ bool Transfers::cancel(const QString &id) {
 }
 
 void Transfers::storeTransfers() {
-    QSettings settings(STORAGE_PATH + "transfers.conf", QSettings::NativeFormat);
-    settings.clear();
+    m_storeTimer.stop();
     
-    foreach (Transfer *transfer, m_transfers) {
-        settings.beginGroup(transfer->id());
-        settings.setValue("downloadPath", transfer->downloadPath());
-        settings.setValue("fileName", transfer->fileName());
-        settings.setValue("category", transfer->category());
-        settings.setValue("priority", Transfer::Priority(transfer->priority()));
-        settings.setValue("size", transfer->size());
-        settings.setValue("service", transfer->service());
-        settings.setValue("resourceId", transfer->resourceId());
-        settings.setValue("streamId", transfer->streamId());
-        settings.setValue("streamUrl", transfer->streamUrl());
-        settings.setValue("title", transfer->title());
-        settings.setValue("convertToAudio", transfer->convertToAudio());
-        settings.setValue("downloadSubtitles", transfer->downloadSubtitles());
-        settings.setValue("subtitlesLanguage", transfer->subtitlesLanguage());
-        settings.endGroup();
+    if ((m_changed.isEmpty()) && (m_removed.isEmpty())) {
+        return;
     }
+    
+    QSqlDatabase db = getDatabase();
+    db.transaction();
+    QSqlQuery query(db);
+    
+    if (!m_removed.isEmpty()) {
+        query.prepare("DELETE FROM transfers WHERE id = ?");
+        
+        foreach (const QString &id, m_removed) {
+            query.addBindValue(id);
+            
+            if (!query.exec()) {
+                break;
+            }
+        }
+    }
+    
+    if ((!query.lastError().isValid()) && (!m_changed.isEmpty())) {
+        QSqlQuery insertQuery(db);
+        insertQuery.prepare("INSERT OR IGNORE INTO transfers (id, position) \
+                            VALUES (?, (SELECT IFNULL(MAX(position), 0) + 1 FROM transfers))");
+        query.prepare("UPDATE transfers SET service = ?, resourceId = ?, streamId = ?, streamUrl = ?, title = ?, \
+                      category = ?, downloadPath = ?, fileName = ?, priority = ?, size = ?, convertToAudio = ?, \
+                      downloadSubtitles = ?, subtitlesLanguage = ?, segments = ? WHERE id = ?");
+        
+        foreach (Transfer *transfer, m_changed) {
+            insertQuery.addBindValue(transfer->id());
+            
+            if (!insertQuery.exec()) {
+                query = insertQuery;
+                break;
+            }
+            
+            query.addBindValue(transfer->service());
+            query.addBindValue(transfer->resourceId());
+            query.addBindValue(transfer->streamId());
+            query.addBindValue(transfer->streamUrl().toString());
+            query.addBindValue(transfer->title());
+            query.addBindValue(transfer->category());
+            query.addBindValue(transfer->downloadPath());
+            query.addBindValue(transfer->fileName());
+            query.addBindValue(int(transfer->priority()));
+            query.addBindValue(transfer->size());
+            query.addBindValue(transfer->convertToAudio());
+            query.addBindValue(transfer->downloadSubtitles());
+            query.addBindValue(transfer->subtitlesLanguage());
+            query.addBindValue(QString::fromUtf8(QtJson::Json::serialize(transfer->segments())));
+            query.addBindValue(transfer->id());
+            
+            if (!query.exec()) {
+                break;
+            }
+        }
+    }
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "Transfers::storeTransfers: database error:" << query.lastError().text();
+        db.rollback();
+        return;
+    }
+    
+    db.commit();
+    m_changed.clear();
+    m_removed.clear();
 }
 
 void Transfers::restoreTransfers() {
+    if (QFile::exists(STORAGE_PATH + "transfers.conf")) {
+        importTransfers();
+        return;
+    }
+    
+    QSqlQuery query = getDatabase().exec("SELECT id, service, resourceId, streamId, streamUrl, title, category, \
+                                          downloadPath, fileName, priority, size, convertToAudio, downloadSubtitles, \
+                                          subtitlesLanguage, segments FROM transfers ORDER BY position");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "Transfers::restoreTransfers: database error:" << query.lastError().text();
+        return;
+    }
+    
+    while (query.next()) {
+        Transfer *transfer = createTransfer(query.value(1).toString(), this);
+        transfer->setId(query.value(0).toString());
+        transfer->setResourceId(query.value(2).toString());
+        transfer->setStreamId(query.value(3).toString());
+        transfer->setStreamUrl(query.value(4).toString());
+        transfer->setTitle(query.value(5).toString());
+        transfer->setCategory(query.value(6).toString());
+        transfer->setDownloadPath(query.value(7).toString());
+        transfer->setFileName(query.value(8).toString());
+        transfer->setPriority(Transfer::Priority(query.value(9).toInt()));
+        transfer->setSize(query.value(10).toLongLong());
+        transfer->setConvertToAudio(query.value(11).toBool());
+        transfer->setDownloadSubtitles(query.value(12).toBool());
+        transfer->setSubtitlesLanguage(query.value(13).toString());
+        transfer->setSegments(JsonParser::parse(query.value(14).toString().toUtf8()).toList());
+        addTransfer(transfer);
+        
+        if ((transfer->size() > 0) && (transfer->bytesTransferred() >= transfer->size())) {
+            transfer->queue();
+        }
+    }
+}
+
+void Transfers::importTransfers() {
     QSettings settings(STORAGE_PATH + "transfers.conf", QSettings::NativeFormat);
 
     foreach (QString group, settings.childGroups()) {
@@ -214,60 +349,180 @@ void Transfers::restoreTransfers() {
         transfer->setConvertToAudio(settings.value("convertToAudio").toBool());
         transfer->setDownloadSubtitles(settings.value("downloadSubtitles").toBool());
         transfer->setSubtitlesLanguage(settings.value("subtitlesLanguage").toString());
+        transfer->setSegments(settings.value("segments").toList());
         settings.endGroup();
+        m_changed.insert(transfer);
+        addTransfer(transfer);
         
-        connect(transfer, SIGNAL(statusChanged()), this, SLOT(onTransferStatusChanged()));
-    
-        m_transfers << transfer;
-        emit countChanged(count());
-        emit transferAdded(transfer);
-    
-        if (Settings::instance()->startTransfersAutomatically()) {
+        if ((transfer->size() > 0) && (transfer->bytesTransferred() >= transfer->size())) {
             transfer->queue();
         }
     }
+    
+    storeTransfers();
+    
+    if (m_changed.isEmpty()) {
+        QFile::remove(settings.fileName());
+    }
 }
 
 void Transfers::getNextTransfers() {
-    const int max = Settings::instance()->maximumConcurrentTransfers();
+    const int max = concurrency();
+    const bool adaptive = Settings::instance()->adaptiveConcurrency();
     
     for (int priority = Transfer::HighPriority; priority <= Transfer::LowPriority; priority++) {
-        foreach (Transfer *transfer, m_transfers) {
-            if ((transfer->priority() == priority) && (transfer->status() == Transfer::Queued)) {
-                if (active() < max) {
-                    addActiveTransfer(transfer);
+        QQueue< QPointer<Transfer> > &queue = m_queued[priority];
+        QQueue< QPointer<Transfer> > skipped;
+        
+        while ((!queue.isEmpty()) && (active() < max)) {
+            Transfer *transfer = queue.dequeue();
+            
+            if ((transfer) && (transfer->status() == Transfer::Queued) && (transfer->priority() == priority)
+                && (!m_active.contains(transfer))) {
+                // Transfers whose download host is not yet known are not capped
+                const QString host = adaptive ? hostKey(transfer) : QString();
+                
+                if ((!host.isEmpty()) && (activeForHost(host) >= MAX_TRANSFERS_PER_HOST)) {
+                    skipped.enqueue(transfer);
                 }
                 else {
-                    return;
+                    addActiveTransfer(transfer);
+                    transfer->start();
                 }
             }
         }
+        
+        while (!skipped.isEmpty()) {
+            queue.prepend(skipped.takeLast());
+        }
     }
 }
 
+bool Transfers::hasQueuedTransfers() const {
+    foreach (const QQueue< QPointer<Transfer> > &queue, m_queued) {
+        foreach (const QPointer<Transfer> &transfer, queue) {
+            if ((transfer) && (transfer->status() == Transfer::Queued)) {
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+QString Transfers::hostKey(Transfer *transfer) {
+    const QString host = transfer->host();
+    return host.isEmpty() ? transfer->streamUrl().host() : host;
+}
+
+int Transfers::activeForHost(const QString &host) const {
+    int count = 0;
+    
+    foreach (Transfer *transfer, m_active) {
+        if (hostKey(transfer) == host) {
+            count++;
+        }
+    }
+    
+    return count;
+}
+
 void Transfers::startNextTransfers() {
     getNextTransfers();
+}
+
+void Transfers::addTransfer(Transfer *transfer) {
+    connect(transfer, SIGNAL(categoryChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(convertToAudioChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(downloadSubtitlesChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(fileNameChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(priorityChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(progressChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(sizeChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(streamIdChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(streamUrlChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(subtitlesLanguageChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(titleChanged()), this, SLOT(onTransferChanged()));
+    connect(transfer, SIGNAL(priorityChanged()), this, SLOT(onTransferPriorityChanged()));
+    connect(transfer, SIGNAL(statusChanged()), this, SLOT(onTransferStatusChanged()));
     
-    foreach (Transfer *transfer, m_active) {
-        transfer->start();
+    transfer->setRateLimiters(QList<RateLimiter*>() << &m_rateLimiter << rateLimiter(transfer->service()));
+    m_transfers << transfer;
+    m_ids[transfer->id()] = transfer;
+    emit countChanged(count());
+    emit transferAdded(transfer);
+    
+    if (Settings::instance()->startTransfersAutomatically()) {
+        transfer->queue();
     }
 }
 
 void Transfers::removeTransfer(Transfer *transfer) {
     removeActiveTransfer(transfer);
     m_transfers.removeOne(transfer);
+    m_ids.remove(transfer->id());
+    m_changed.remove(transfer);
+    m_removed.insert(transfer->id());
     transfer->deleteLater();
     emit countChanged(count());
 }
 
 void Transfers::addActiveTransfer(Transfer *transfer) {
-    m_active << transfer;
+    m_active.insert(transfer);
     emit activeChanged(active());
+    
+    if (!m_progressTimer.isActive()) {
+        m_progressTimer.start();
+    }
 }
 
 void Transfers::removeActiveTransfer(Transfer *transfer) {
-    m_active.removeOne(transfer);
-    emit activeChanged(active());
+    m_bytesTransferred.remove(transfer);
+    
+    if (m_active.remove(transfer)) {
+        emit activeChanged(active());
+    }
+}
+
+void Transfers::queueTransfer(Transfer *transfer) {
+    m_queued[transfer->priority()].enqueue(transfer);
+    
+    if (active() < concurrency()) {
+        m_queueTimer.start();
+    }
+}
+
+RateLimiter* Transfers::rateLimiter(const QString &service) {
+    RateLimiter *limiter = m_rateLimiters.value(service);
+    
+    if (!limiter) {
+        limiter = new RateLimiter(Settings::instance()->maximumDownloadSpeed(service) * 1024);
+        m_rateLimiters[service] = limiter;
+    }
+    
+    return limiter;
+}
+
+void Transfers::storeTransfer(Transfer *transfer) {
+    m_changed.insert(transfer);
+    
+    if (!m_storeTimer.isActive()) {
+        m_storeTimer.start();
+    }
+}
+
+void Transfers::onTransferChanged() {
+    if (Transfer *transfer = qobject_cast<Transfer*>(sender())) {
+        storeTransfer(transfer);
+    }
+}
+
+void Transfers::onTransferPriorityChanged() {
+    if (Transfer *transfer = qobject_cast<Transfer*>(sender())) {
+        if (transfer->status() == Transfer::Queued) {
+            queueTransfer(transfer);
+        }
+    }
 }
 
 void Transfers::onTransferStatusChanged() {
@@ -275,6 +530,9 @@ void Transfers::onTransferStatusChanged() {
         switch (transfer->status()) {
         case Transfer::Paused:
         case Transfer::Failed:
+        case Transfer::Pending:
+        case Transfer::Converting:
+        case Transfer::Moving:
             removeActiveTransfer(transfer);
             break;
         case Transfer::Canceled:
@@ -283,18 +541,24 @@ void Transfers::onTransferStatusChanged() {
             storeTransfers();
             break;
         case Transfer::Queued:
-            break;
+            removeActiveTransfer(transfer);
+            queueTransfer(transfer);
+            return;
         default:
             return;
         }
                 
-        if (active() < Settings::instance()->maximumConcurrentTransfers()) {
+        if (active() < concurrency()) {
             m_queueTimer.start();
         }
     }
 }
 
 void Transfers::onMaximumConcurrentTransfersChanged() {
+    if (Settings::instance()->adaptiveConcurrency()) {
+        return;
+    }
+    
     const int max = Settings::instance()->maximumConcurrentTransfers();
     int act = active();
     
@@ -303,9 +567,9 @@ void Transfers::onMaximumConcurrentTransfersChanged() {
     }
     else if (act > max) {
         for (int priority = Transfer::LowPriority; priority >= Transfer::HighPriority; priority--) {
-            for (int i = m_active.size() - 1; i >= 0; i--) {
-                if (m_active.at(i)->priority() == priority) {
-                    m_active.at(i)->pause();
+            foreach (Transfer *transfer, m_active) {
+                if (transfer->priority() == priority) {
+                    transfer->pause();
                     act--;
                 
                     if (act == max) {
@@ -316,3 +580,122 @@ void Transfers::onMaximumConcurrentTransfersChanged() {
         }
     }
 }
+
+void Transfers::onMaximumDownloadSpeedChanged() {
+    m_rateLimiter.setRate(Settings::instance()->maximumDownloadSpeed() * 1024);
+    QHashIterator<QString, RateLimiter*> iterator(m_rateLimiters);
+    
+    while (iterator.hasNext()) {
+        iterator.next();
+        iterator.value()->setRate(Settings::instance()->maximumDownloadSpeed(iterator.key()) * 1024);
+    }
+}
+
+void Transfers::onAdaptiveConcurrencyChanged() {
+    if (Settings::instance()->adaptiveConcurrency()) {
+        m_concurrency = Settings::instance()->maximumConcurrentTransfers();
+        m_bytesTransferred.clear();
+        m_sampled = 0;
+        m_sampleTimer.start();
+        emit concurrencyChanged(concurrency());
+        m_queueTimer.start();
+    }
+    else {
+        m_sampleTimer.stop();
+        m_bytesTransferred.clear();
+        m_samples.clear();
+        m_throughput = 0;
+        emit throughputChanged(0);
+        emit concurrencyChanged(concurrency());
+        onMaximumConcurrentTransfersChanged();
+    }
+}
+
+void Transfers::onSampleTimerTimeout() {
+    qint64 bytes = 0;
+    int sampled = 0;
+    QVariantMap rates;
+    
+    foreach (Transfer *transfer, m_active) {
+        const qint64 current = transfer->bytesTransferred();
+        
+        if (m_bytesTransferred.contains(transfer)) {
+            const qint64 delta = qMax(qint64(0), current - m_bytesTransferred.value(transfer));
+            rates[transfer->id()] = delta * 1000 / SAMPLE_INTERVAL;
+            bytes += delta;
+            sampled++;
+        }
+        
+        m_bytesTransferred[transfer] = current;
+    }
+    
+    if (sampled == 0) {
+        m_sampled = 0;
+        return;
+    }
+    
+    const qint64 previous = m_throughput;
+    const int previousSampled = m_sampled;
+    m_throughput = bytes * 1000 / SAMPLE_INTERVAL;
+    m_sampled = sampled;
+    emit throughputChanged(m_throughput);
+    
+    const bool saturated = (active() >= m_concurrency) && (hasQueuedTransfers());
+    
+    if ((previous <= 0) || (previousSampled <= 0)) {
+        if (saturated) {
+            setConcurrency(m_concurrency + 1);
+        }
+    }
+    else if (sampled == previousSampled) {
+        if (m_throughput < previous * CONCURRENCY_DECREASE_THRESHOLD) {
+            setConcurrency(m_concurrency / 2);
+        }
+        else if (saturated) {
+            setConcurrency(m_concurrency + 1);
+        }
+    }
+    else if (sampled > previousSampled) {
+        if (m_throughput < previous * CONCURRENCY_INCREASE_THRESHOLD) {
+            setConcurrency(m_concurrency / 2);
+        }
+        else if (saturated) {
+            setConcurrency(m_concurrency + 1);
+        }
+    }
+    
+    QVariantMap sample;
+    sample["time"] = QDateTime::currentMSecsSinceEpoch();
+    sample["concurrency"] = m_concurrency;
+    sample["active"] = active();
+    sample["throughput"] = m_throughput;
+    sample["transferThroughput"] = m_throughput / sampled;
+    sample["transfers"] = rates;
+    m_samples << sample;
+    
+    while (m_samples.size() > MAX_THROUGHPUT_SAMPLES) {
+        m_samples.removeFirst();
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "Transfers::onSampleTimerTimeout" << m_throughput << m_concurrency << active();
+#endif
+}
+
+void Transfers::onProgressTimerTimeout() {
+    if (m_active.isEmpty()) {
+        m_progressTimer.stop();
+        return;
+    }
+    
+    QList<Transfer*> changed;
+    
+    foreach (Transfer *transfer, m_active) {
+        if (transfer->updateProgress()) {
+            changed << transfer;
+        }
+    }
+    
+    if (!changed.isEmpty()) {
+        emit progressChanged(changed);
+    }
+}
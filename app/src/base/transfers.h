@@ -17,8 +17,13 @@
 #ifndef TRANSFERS_H
 #define TRANSFERS_H
 
+#include "ratelimiter.h"
 #include "transfer.h"
+#include <QPointer>
+#include <QQueue>
+#include <QSet>
 #include <QTimer>
+#include <QVector>
 
 class QNetworkAccessManager;
 
@@ -27,7 +32,9 @@ class Transfers : public QObject
     Q_OBJECT
     
     Q_PROPERTY(int active READ active NOTIFY activeChanged)
+    Q_PROPERTY(int concurrency READ concurrency NOTIFY concurrencyChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(qint64 throughput READ throughput NOTIFY throughputChanged)
     
 public:
     explicit Transfers(QObject *parent = 0);
@@ -36,11 +43,16 @@ public:
     static Transfers* instance();
         
     int active() const;
+    int concurrency() const;
     int count() const;
+    qint64 throughput() const;
     
-    Q_INVOKABLE void addDownloadTransfer(const QString &service, const QString &resourceId, const QString &streamId,
-                                         const QUrl &streamUrl, const QString &title, const QString &category,
-                                         const QString &subtitlesLanguage = QString(), bool convertToAudio = false);
+    Q_INVOKABLE QVariantList throughputSamples() const;
+    
+    Q_INVOKABLE Transfer* addDownloadTransfer(const QString &service, const QString &resourceId,
+                                              const QString &streamId, const QUrl &streamUrl, const QString &title,
+                                              const QString &category, const QString &subtitlesLanguage = QString(),
+                                              bool convertToAudio = false);
     
     Q_INVOKABLE Transfer* get(int i) const;
     Q_INVOKABLE Transfer* get(const QString &id) const;
@@ -57,21 +69,44 @@ public Q_SLOTS:
     
 private:
     void getNextTransfers();
+    bool hasQueuedTransfers() const;
+    
+    static QString hostKey(Transfer *transfer);
+    int activeForHost(const QString &host) const;
+    
+    void setConcurrency(int c);
     
+    void addTransfer(Transfer *transfer);
     void removeTransfer(Transfer *transfer);
+    
+    void importTransfers();
+    void storeTransfer(Transfer *transfer);
 
     void addActiveTransfer(Transfer *transfer);
     void removeActiveTransfer(Transfer *transfer);
+    
+    void queueTransfer(Transfer *transfer);
+    
+    RateLimiter* rateLimiter(const QString &service);
 
 private Q_SLOTS:
     void startNextTransfers();
     
+    void onTransferChanged();
+    void onTransferPriorityChanged();
     void onTransferStatusChanged();
     void onMaximumConcurrentTransfersChanged();
+    void onMaximumDownloadSpeedChanged();
+    void onAdaptiveConcurrencyChanged();
+    void onSampleTimerTimeout();
+    void onProgressTimerTimeout();
     
 Q_SIGNALS:
     void activeChanged(int a);
+    void concurrencyChanged(int c);
     void countChanged(int c);
+    void progressChanged(const QList<Transfer*> &transfers);
+    void throughputChanged(qint64 t);
     void transferAdded(Transfer *transfer);
     
 private:
@@ -80,9 +115,26 @@ private:
     QNetworkAccessManager *m_nam;
     
     QTimer m_queueTimer;
+    QTimer m_storeTimer;
+    QTimer m_sampleTimer;
+    QTimer m_progressTimer;
     
     QList<Transfer*> m_transfers;
-    QList<Transfer*> m_active;
+    QHash<QString, Transfer*> m_ids;
+    QSet<Transfer*> m_active;
+    QVector< QQueue< QPointer<Transfer> > > m_queued;
+    
+    QSet<Transfer*> m_changed;
+    QSet<QString> m_removed;
+    
+    int m_concurrency;
+    qint64 m_throughput;
+    int m_sampled;
+    QHash<Transfer*, qint64> m_bytesTransferred;
+    QVariantList m_samples;
+    
+    RateLimiter m_rateLimiter;
+    QHash<QString, RateLimiter*> m_rateLimiters;
 };
     
 #endif // TRANSFERS_H
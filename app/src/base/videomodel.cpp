@@ -20,75 +20,29 @@
 #endif
 
 VideoModel::VideoModel(QObject *parent) :
-    QAbstractListModel(parent)
+    RoleListModel(parent)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DurationRole] = "duration";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ServiceRole] = "service";
-    m_roles[StreamUrlRole] = "streamUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
-    m_roles[ViewCountRole] = "viewCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
-}
-
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> VideoModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
-int VideoModel::rowCount(const QModelIndex &) const {
-    return m_items.size();
-}
-
-QVariant VideoModel::data(const QModelIndex &index, int role) const {
-    if (CTVideo *video = get(index.row())) {
-        return video->property(m_roles[role]);
-    }
+    static RoleTable<CTVideo> roles;
     
-    return QVariant();
-}
-
-QMap<int, QVariant> VideoModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (CTVideo *video = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = video->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant VideoModel::data(int row, const QByteArray &role) const {
-    if (CTVideo *video = get(row)) {
-        return video->property(role);
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTVideo::date);
+        roles.insert(DescriptionRole, "description", &CTVideo::description);
+        roles.insert(DurationRole, "duration", &CTVideo::duration);
+        roles.insert(IdRole, "id", &CTVideo::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTVideo::largeThumbnailUrl);
+        roles.insert(ServiceRole, "service", &CTVideo::service);
+        roles.insert(StreamUrlRole, "streamUrl", &CTVideo::streamUrl);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTVideo::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTVideo::title);
+        roles.insert(UrlRole, "url", &CTVideo::url);
+        roles.insert(ViewCountRole, "viewCount", &CTVideo::viewCount);
     }
     
-    return QVariant();
+    setRoleTable(&roles);
 }
 
-QVariantMap VideoModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (CTVideo *video = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = video->property(role);
-        }
-    }
-    
-    return map;
+int VideoModel::rowCount(const QModelIndex &) const {
+    return m_items.size();
 }
 
 CTVideo* VideoModel::get(int row) const {
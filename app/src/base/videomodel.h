@@ -18,9 +18,9 @@
 #define VIDEOMODEL_H
 
 #include "video.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class VideoModel : public QAbstractListModel
+class VideoModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -43,17 +43,8 @@ public:
     
     explicit VideoModel(QObject *parent = 0);
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
         
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE CTVideo* get(int row) const;
     Q_INVOKABLE void append(CTVideo *video);
     Q_INVOKABLE void insert(int row, CTVideo *video);
@@ -67,8 +58,6 @@ Q_SIGNALS:
     
 private:
     QList<CTVideo*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // VIDEOMODEL_H
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIDEOREGISTRY_H
+#define VIDEOREGISTRY_H
+
+#include <QHash>
+#include <QMultiHash>
+#include <QString>
+
+template <class T>
+class VideoRegistry
+{
+
+public:
+    void insert(T *video) {
+        remove(video);
+        const QString id = video->id();
+        
+        if (!id.isEmpty()) {
+            m_ids.insert(video, id);
+            m_videos.insert(id, video);
+        }
+    }
+    
+    void remove(T *video) {
+        if (m_ids.contains(video)) {
+            m_videos.remove(m_ids.take(video), video);
+        }
+    }
+    
+    void update(T *video) {
+        foreach (T *v, m_videos.values(video->id())) {
+            if (v != video) {
+                v->loadVideo(video);
+            }
+        }
+    }
+
+private:
+    QMultiHash<QString, T*> m_videos;
+    QHash<T*, QString> m_ids;
+};
+
+#endif // VIDEOREGISTRY_H
@@ -16,9 +16,8 @@
 
 #include "dailymotion.h"
 #include "database.h"
+#include "settings.h"
 #include <qdailymotion/urls.h>
-#include <QSettings>
-#include <QSqlRecord>
 #if QT_VERSION >= 0x050000
 #include <QUrlQuery>
 #endif
@@ -59,6 +58,7 @@ const QStringList Dailymotion::VIDEO_FIELDS = QStringList() << "id" << "created_
                                                 
 const QRegExp Dailymotion::URL_REGEXP("(http(s|)://(www.|)dailymotion.com/|http://dai.ly/)\\w+", Qt::CaseInsensitive);
 
+Dailymotion::AccountCache Dailymotion::accountCache;
 Dailymotion::SubscriptionCache Dailymotion::subscriptionCache;
 
 Dailymotion* Dailymotion::self = 0;
@@ -81,6 +81,32 @@ Dailymotion* Dailymotion::instance() {
     return self;
 }
 
+void Dailymotion::reloadAccounts() {
+    accountCache.accounts.clear();
+    accountCache.loaded = false;
+}
+
+Dailymotion::Account Dailymotion::account(const QString &userId) {
+    if (!accountCache.loaded) {
+        accountCache.loaded = true;
+        QSqlQuery query = getDatabase().exec("SELECT userId, accessToken, refreshToken, scopes FROM dailymotionAccounts");
+        
+        if (query.lastError().isValid()) {
+            qDebug() << "Dailymotion::account: database error:" << query.lastError().text();
+        }
+        
+        while (query.next()) {
+            Account account;
+            account.accessToken = query.value(1).toString();
+            account.refreshToken = query.value(2).toString();
+            account.scopes = query.value(3).toString();
+            accountCache.accounts[query.value(0).toString()] = account;
+        }
+    }
+    
+    return accountCache.accounts.value(userId);
+}
+
 QString Dailymotion::getErrorString(const QVariantMap &error) {
     QVariantMap em = error.contains("error") ? error.value("error").toMap() : error;
 
@@ -123,12 +149,12 @@ QUrl Dailymotion::authUrl() const {
 }
 
 QString Dailymotion::userId() const {
-    return QSettings().value("Dailymotion/userId").toString();
+    return Settings::instance()->value("Dailymotion/userId").toString();
 }
 
 void Dailymotion::setUserId(const QString &id) {
     if (id != userId()) {
-        QSettings().setValue("Dailymotion/userId", id);
+        Settings::instance()->setValue("Dailymotion/userId", id);
         subscriptionCache.ids.clear();
         subscriptionCache.filters.clear();
         subscriptionCache.hasMore = true;
@@ -141,29 +167,25 @@ QString Dailymotion::accessToken() const {
         return QString();
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT accessToken FROM dailymotionAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "Dailymotion::accessToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    return account(userId()).accessToken;
 }
 
 void Dailymotion::setAccessToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE dailymotionAccounts SET accessToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE dailymotionAccounts SET accessToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "Dailymotion::setAccessToken: database error:" << query.lastError().text();
     }
     else {
+        QHash<QString, Account>::iterator iterator = accountCache.accounts.find(userId());
+        
+        if (iterator != accountCache.accounts.end()) {
+            iterator.value().accessToken = token;
+        }
+        
         emit accessTokenChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -176,29 +198,25 @@ QString Dailymotion::refreshToken() const {
         return QString();
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT refreshToken FROM dailymotionAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "Dailymotion::refreshToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    return account(userId()).refreshToken;
 }
 
 void Dailymotion::setRefreshToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE dailymotionAccounts SET refreshToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE dailymotionAccounts SET refreshToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "Dailymotion::setRefreshToken: database error:" << query.lastError().text();
     }
     else {
+        QHash<QString, Account>::iterator iterator = accountCache.accounts.find(userId());
+        
+        if (iterator != accountCache.accounts.end()) {
+            iterator.value().refreshToken = token;
+        }
+        
         emit accessTokenChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -207,12 +225,12 @@ void Dailymotion::setRefreshToken(const QString &token) {
 }
 
 QString Dailymotion::clientId() const {
-    return QSettings().value("Dailymotion/clientId", CLIENT_ID).toString();
+    return Settings::instance()->value("Dailymotion/clientId", CLIENT_ID).toString();
 }
 
 void Dailymotion::setClientId(const QString &id) {
     if (id != clientId()) {
-        QSettings().setValue("Dailymotion/clientId", id);
+        Settings::instance()->setValue("Dailymotion/clientId", id);
         emit clientIdChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -221,12 +239,12 @@ void Dailymotion::setClientId(const QString &id) {
 }
 
 QString Dailymotion::clientSecret() const {
-    return QSettings().value("Dailymotion/clientSecret", CLIENT_SECRET).toString();
+    return Settings::instance()->value("Dailymotion/clientSecret", CLIENT_SECRET).toString();
 }
 
 void Dailymotion::setClientSecret(const QString &secret) {
     if (secret != clientSecret()) {
-        QSettings().setValue("Dailymotion/clientSecret", secret);
+        Settings::instance()->setValue("Dailymotion/clientSecret", secret);
         emit clientSecretChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -235,12 +253,12 @@ void Dailymotion::setClientSecret(const QString &secret) {
 }
 
 QString Dailymotion::redirectUri() const {
-    return QSettings().value("Dailymotion/redirectUri", REDIRECT_URI).toString();
+    return Settings::instance()->value("Dailymotion/redirectUri", REDIRECT_URI).toString();
 }
 
 void Dailymotion::setRedirectUri(const QString &uri) {
     if (uri != redirectUri()) {
-        QSettings().setValue("Dailymotion/redirectUri", uri);
+        Settings::instance()->setValue("Dailymotion/redirectUri", uri);
         emit redirectUriChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -249,12 +267,12 @@ void Dailymotion::setRedirectUri(const QString &uri) {
 }
 
 QStringList Dailymotion::scopes() const {
-    return QSettings().value("Dailymotion/scopes", SCOPES).toStringList();
+    return Settings::instance()->value("Dailymotion/scopes", SCOPES).toStringList();
 }
 
 void Dailymotion::setScopes(const QStringList &s) {
     if (s != scopes()) {
-        QSettings().setValue("Dailymotion/scopes", s);
+        Settings::instance()->setValue("Dailymotion/scopes", s);
         emit scopesChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -267,19 +285,7 @@ bool Dailymotion::hasScope(const QString &scope) const {
         return false;
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT scopes FROM dailymotionAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "Dailymotion::hasScope: database error:" << query.lastError().text();
-        return false;
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString().contains(scope);
-    }
-    
-    return false;
+    return account(userId()).scopes.contains(scope);
 }
 
 QString Dailymotion::emailScope() {
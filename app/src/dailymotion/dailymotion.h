@@ -63,6 +63,8 @@ public:
     static const QRegExp URL_REGEXP;
     
     static Dailymotion* instance();
+    
+    static void reloadAccounts();
             
     Q_INVOKABLE static QString getErrorString(const QVariantMap &error);
     
@@ -144,6 +146,25 @@ private:
         }
     };
     
+    struct Account {
+        QString accessToken;
+        QString refreshToken;
+        QString scopes;
+    };
+    
+    struct AccountCache {
+        QHash<QString, Account> accounts;
+        bool loaded;
+        
+        AccountCache() :
+            loaded(false)
+        {
+        }
+    };
+    
+    static Account account(const QString &userId);
+    
+    static AccountCache accountCache;
     static SubscriptionCache subscriptionCache;
     static Dailymotion *self;
     
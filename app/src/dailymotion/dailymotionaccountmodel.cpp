@@ -16,6 +16,7 @@
 
 #include "dailymotionaccountmodel.h"
 #include "dailymotion.h"
+#include "responsecache.h"
 #include <QSqlRecord>
 #include <QSqlField>
 #include <QSqlError>
@@ -91,6 +92,8 @@ bool DailymotionAccountModel::addAccount(const QString &userId, const QString &u
     record.append(scopesField);
     
     if (insertRecord(-1, record)) {
+        Dailymotion::reloadAccounts();
+        ResponseCache::instance()->clear();
         Dailymotion::instance()->setUserId(userId);
         const int count = rowCount();
         emit dataChanged(index(0, 0), index(count - 1, columnCount() - 1));
@@ -105,6 +108,9 @@ bool DailymotionAccountModel::removeAccount(int row) {
     QString userId = data(index(row, 0)).toString();
     
     if (removeRows(row, 1)) {
+        Dailymotion::reloadAccounts();
+        ResponseCache::instance()->clear();
+        
         if (userId == Dailymotion::instance()->userId()) {
             if (rowCount() > 0) {
                 selectAccount(0);
@@ -21,20 +21,24 @@
 #endif
 
 DailymotionCommentModel::DailymotionCommentModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QDailymotion::ResourcesRequest(this)),
     m_hasMore(false)
 {
-    m_roles[BodyRole] = "body";
-    m_roles[DateRole] = "date";
-    m_roles[IdRole] = "id";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoIdRole] = "videoId";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<DailymotionComment> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BodyRole, "body", &CTComment::body);
+        roles.insert(DateRole, "date", &CTComment::date);
+        roles.insert(IdRole, "id", &CTComment::id);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTComment::thumbnailUrl);
+        roles.insert(UserIdRole, "userId", &CTComment::userId);
+        roles.insert(UsernameRole, "username", &CTComment::username);
+        roles.insert(VideoIdRole, "videoId", &CTComment::videoId);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setClientId(Dailymotion::instance()->clientId());
     m_request->setClientSecret(Dailymotion::instance()->clientSecret());
     m_request->setAccessToken(Dailymotion::instance()->accessToken());
@@ -55,12 +59,6 @@ QDailymotion::ResourcesRequest::Status DailymotionCommentModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> DailymotionCommentModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int DailymotionCommentModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -80,49 +78,6 @@ void DailymotionCommentModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant DailymotionCommentModel::data(const QModelIndex &index, int role) const {
-    if (DailymotionComment *user = get(index.row())) {
-        return user->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> DailymotionCommentModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (DailymotionComment *user = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = user->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant DailymotionCommentModel::data(int row, const QByteArray &role) const {
-    if (DailymotionComment *user = get(row)) {
-        return user->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap DailymotionCommentModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (DailymotionComment *user = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = user->property(role);
-        }
-    }
-    
-    return map;
-}
-
 DailymotionComment* DailymotionCommentModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
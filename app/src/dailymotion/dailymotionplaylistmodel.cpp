@@ -21,22 +21,26 @@
 #endif
 
 DailymotionPlaylistModel::DailymotionPlaylistModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QDailymotion::ResourcesRequest(this)),
     m_hasMore(false)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoCountRole] = "videoCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<DailymotionPlaylist> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTPlaylist::date);
+        roles.insert(DescriptionRole, "description", &CTPlaylist::description);
+        roles.insert(IdRole, "id", &CTPlaylist::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTPlaylist::largeThumbnailUrl);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTPlaylist::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTPlaylist::title);
+        roles.insert(UserIdRole, "userId", &CTPlaylist::userId);
+        roles.insert(UsernameRole, "username", &CTPlaylist::username);
+        roles.insert(VideoCountRole, "videoCount", &CTPlaylist::videoCount);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setClientId(Dailymotion::instance()->clientId());
     m_request->setClientSecret(Dailymotion::instance()->clientSecret());
     m_request->setAccessToken(Dailymotion::instance()->accessToken());
@@ -55,12 +59,6 @@ QDailymotion::ResourcesRequest::Status DailymotionPlaylistModel::status() const
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> DailymotionPlaylistModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int DailymotionPlaylistModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -80,49 +78,6 @@ void DailymotionPlaylistModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant DailymotionPlaylistModel::data(const QModelIndex &index, int role) const {
-    if (DailymotionPlaylist *playlist = get(index.row())) {
-        return playlist->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> DailymotionPlaylistModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (DailymotionPlaylist *playlist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = playlist->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant DailymotionPlaylistModel::data(int row, const QByteArray &role) const {
-    if (DailymotionPlaylist *playlist = get(row)) {
-        return playlist->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap DailymotionPlaylistModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (DailymotionPlaylist *playlist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = playlist->property(role);
-        }
-    }
-    
-    return map;
-}
-
 DailymotionPlaylist* DailymotionPlaylistModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
@@ -15,10 +15,13 @@
  */
 
 #include "dailymotionstreammodel.h"
+#include "resources.h"
+#include "streamcache.h"
 
 DailymotionStreamModel::DailymotionStreamModel(QObject *parent) :
     SelectionModel(parent),
-    m_request(new QDailymotion::StreamsRequest(this))
+    m_request(new QDailymotion::StreamsRequest(this)),
+    m_status(m_request->status())
 {
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -28,7 +31,7 @@ QString DailymotionStreamModel::errorString() const {
 }
 
 QDailymotion::StreamsRequest::Status DailymotionStreamModel::status() const {
-    return m_request->status();
+    return m_status;
 }
 
 void DailymotionStreamModel::list(const QString &id) {
@@ -38,27 +41,48 @@ void DailymotionStreamModel::list(const QString &id) {
     
     clear();
     m_id = id;
-    m_request->list(id);
+    const QVariantList streams = StreamCache::instance()->streams(Resources::DAILYMOTION, id);
+    
+    if (!streams.isEmpty()) {
+        loadStreams(streams);
+        m_status = QDailymotion::StreamsRequest::Ready;
+    }
+    else {
+        m_request->list(id);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
 }
 
 void DailymotionStreamModel::cancel() {
     m_request->cancel();
+    m_status = m_request->status();
 }
 
 void DailymotionStreamModel::reload() {
+    StreamCache::instance()->remove(Resources::DAILYMOTION, m_id);
     clear();
     m_request->list(m_id);
+    m_status = m_request->status();
     emit statusChanged(status());
 }
 
+void DailymotionStreamModel::loadStreams(const QVariantList &streams) {
+    foreach (QVariant v, streams) {
+        QVariantMap stream = v.toMap();
+        append(QString("%1p %2").arg(stream.value("height").toInt()).arg(stream.value("description").toString()),
+               stream);
+    }
+}
+
 void DailymotionStreamModel::onRequestFinished() {
-    if (m_request->status() == QDailymotion::StreamsRequest::Ready) {
-        foreach (QVariant v, m_request->result().toList()) {
-            QVariantMap stream = v.toMap();
-            append(QString("%1p %2").arg(stream.value("height").toInt()).arg(stream.value("description").toString()),
-                   stream);
-        }
+    m_status = m_request->status();
+    
+    if (m_status == QDailymotion::StreamsRequest::Ready) {
+        const QVariantList streams = m_request->result().toList();
+        StreamCache::instance()->insert(Resources::DAILYMOTION, m_id, streams);
+        loadStreams(streams);
     }
     
     emit statusChanged(status());
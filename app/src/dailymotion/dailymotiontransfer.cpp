@@ -15,6 +15,8 @@
  */
 
 #include "dailymotiontransfer.h"
+#include "resources.h"
+#include "streamcache.h"
 #include <qdailymotion/resourcesrequest.h>
 #include <qdailymotion/streamsrequest.h>
 #ifdef CUTETUBE_DEBUG
@@ -26,9 +28,17 @@ DailymotionTransfer::DailymotionTransfer(QObject *parent) :
     m_streamsRequest(0),
     m_subtitlesRequest(0)
 {
+    setService(Resources::DAILYMOTION);
 }
 
 void DailymotionTransfer::listStreams() {
+    const QVariantMap stream = selectStream(StreamCache::instance()->streams(service(), resourceId()));
+    
+    if (!stream.isEmpty()) {
+        startDownload(stream.value("url").toString());
+        return;
+    }
+    
     if (!m_streamsRequest) {
         m_streamsRequest = new QDailymotion::StreamsRequest(this);
         connect(m_streamsRequest, SIGNAL(finished()), this, SLOT(onStreamsRequestFinished()));
@@ -49,14 +59,12 @@ void DailymotionTransfer::listSubtitles() {
 void DailymotionTransfer::onStreamsRequestFinished() {
     if (m_streamsRequest->status() == QDailymotion::StreamsRequest::Ready) {
         QVariantList list = m_streamsRequest->result().toList();
+        StreamCache::instance()->insert(service(), resourceId(), list);
+        const QVariantMap stream = selectStream(list);
         
-        foreach (QVariant v, list) {
-            QVariantMap stream = v.toMap();
-        
-            if (stream.value("id") == streamId()) {
-                startDownload(stream.value("url").toString());
-                return;
-            }
+        if (!stream.isEmpty()) {
+            startDownload(stream.value("url").toString());
+            return;
         }
     }
     
@@ -80,10 +88,5 @@ void DailymotionTransfer::onSubtitlesRequestFinished() {
 #ifdef CUTETUBE_DEBUG
     qDebug() << "DailymotionTransfer::onSubtitlesRequestFinished: No subtitles found";
 #endif
-    if (convertToAudio()) {
-        startAudioConversion();
-    }
-    else {
-        moveDownloadedFiles();
-    }
+    finishSubtitlesDownload();
 }
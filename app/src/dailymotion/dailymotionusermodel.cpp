@@ -21,22 +21,26 @@
 #endif
 
 DailymotionUserModel::DailymotionUserModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QDailymotion::ResourcesRequest(this)),
     m_hasMore(false)
 {
-    m_roles[BannerUrlRole] = "bannerUrl";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeBannerUrlRole] = "largeBannerUrl";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[SubscribedRole] = "subscribed";
-    m_roles[SubscriberCountRole] = "subscriberCount";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UsernameRole] = "username";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<DailymotionUser> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BannerUrlRole, "bannerUrl", &DailymotionUser::bannerUrl);
+        roles.insert(DescriptionRole, "description", &CTUser::description);
+        roles.insert(IdRole, "id", &CTUser::id);
+        roles.insert(LargeBannerUrlRole, "largeBannerUrl", &DailymotionUser::largeBannerUrl);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTUser::largeThumbnailUrl);
+        roles.insert(SubscribedRole, "subscribed", &DailymotionUser::isSubscribed);
+        roles.insert(SubscriberCountRole, "subscriberCount", &DailymotionUser::subscriberCount);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTUser::thumbnailUrl);
+        roles.insert(UsernameRole, "username", &CTUser::username);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setClientId(Dailymotion::instance()->clientId());
     m_request->setClientSecret(Dailymotion::instance()->clientSecret());
     m_request->setAccessToken(Dailymotion::instance()->accessToken());
@@ -55,12 +59,6 @@ QDailymotion::ResourcesRequest::Status DailymotionUserModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> DailymotionUserModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int DailymotionUserModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -80,49 +78,6 @@ void DailymotionUserModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant DailymotionUserModel::data(const QModelIndex &index, int role) const {
-    if (DailymotionUser *user = get(index.row())) {
-        return user->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> DailymotionUserModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (DailymotionUser *user = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = user->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant DailymotionUserModel::data(int row, const QByteArray &role) const {
-    if (DailymotionUser *user = get(row)) {
-        return user->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap DailymotionUserModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (DailymotionUser *user = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = user->property(role);
-        }
-    }
-    
-    return map;
-}
-
 DailymotionUser* DailymotionUserModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
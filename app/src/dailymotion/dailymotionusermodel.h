@@ -18,9 +18,9 @@
 #define DAILYMOTIONUSERMODEL_H
 
 #include "dailymotionuser.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class DailymotionUserModel : public QAbstractListModel
+class DailymotionUserModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -49,20 +49,11 @@ public:
     
     QDailymotion::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE DailymotionUser* get(int row) const;
     
     Q_INVOKABLE void list(const QString &resourcePath, const QVariantMap &filters = QVariantMap());
@@ -95,8 +86,6 @@ private:
     bool m_hasMore;
         
     QList<DailymotionUser*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // DAILYMOTIONUSERMODEL_H
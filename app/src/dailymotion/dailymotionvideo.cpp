@@ -23,16 +23,16 @@
 #include <QDebug>
 #endif
 
+VideoRegistry<DailymotionVideo> DailymotionVideo::registry;
+
 DailymotionVideo::DailymotionVideo(QObject *parent) :
     CTVideo(parent),
     m_request(0),
     m_favourite(false)
 {
     setService(Resources::DAILYMOTION);
-    connect(Dailymotion::instance(), SIGNAL(videoFavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
-    connect(Dailymotion::instance(), SIGNAL(videoUnfavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 DailymotionVideo::DailymotionVideo(const QString &id, QObject *parent) :
@@ -42,10 +42,8 @@ DailymotionVideo::DailymotionVideo(const QString &id, QObject *parent) :
 {
     setService(Resources::DAILYMOTION);
     loadVideo(id);
-    connect(Dailymotion::instance(), SIGNAL(videoFavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
-    connect(Dailymotion::instance(), SIGNAL(videoUnfavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 DailymotionVideo::DailymotionVideo(const QVariantMap &video, QObject *parent) :
@@ -55,10 +53,8 @@ DailymotionVideo::DailymotionVideo(const QVariantMap &video, QObject *parent) :
 {
     setService(Resources::DAILYMOTION);
     loadVideo(video);
-    connect(Dailymotion::instance(), SIGNAL(videoFavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
-    connect(Dailymotion::instance(), SIGNAL(videoUnfavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 DailymotionVideo::DailymotionVideo(const DailymotionVideo *video, QObject *parent) :
@@ -66,10 +62,12 @@ DailymotionVideo::DailymotionVideo(const DailymotionVideo *video, QObject *paren
     m_request(0),
     m_favourite(video->isFavourite())
 {
-    connect(Dailymotion::instance(), SIGNAL(videoFavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
-    connect(Dailymotion::instance(), SIGNAL(videoUnfavourited(DailymotionVideo*)),
-            this, SLOT(onVideoUpdated(DailymotionVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+}
+
+DailymotionVideo::~DailymotionVideo() {
+    registry.remove(this);
 }
 
 QString DailymotionVideo::errorString() const {
@@ -179,6 +177,7 @@ void DailymotionVideo::onVideoRequestFinished() {
 void DailymotionVideo::onFavouriteRequestFinished() {
     if (m_request->status() == QDailymotion::ResourcesRequest::Ready) {
         setFavourite(true);
+        registry.update(this);
         emit Dailymotion::instance()->videoFavourited(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "DailymotionVideo::onFavouriteRequestFinished OK" << id();
@@ -192,6 +191,7 @@ void DailymotionVideo::onFavouriteRequestFinished() {
 void DailymotionVideo::onUnfavouriteRequestFinished() {
     if (m_request->status() == QDailymotion::ResourcesRequest::Ready) {
         setFavourite(false);
+        registry.update(this);
         emit Dailymotion::instance()->videoUnfavourited(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "DailymotionVideo::onUnfavouriteRequestFinished OK" << id();
@@ -202,8 +202,6 @@ void DailymotionVideo::onUnfavouriteRequestFinished() {
     emit statusChanged(status());
 }
 
-void DailymotionVideo::onVideoUpdated(DailymotionVideo *video) {
-    if ((video->id() == id()) && (video != this)) {
-        loadVideo(video);
-    }
+void DailymotionVideo::onIdChanged() {
+    registry.insert(this);
 }
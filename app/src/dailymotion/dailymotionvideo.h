@@ -18,6 +18,7 @@
 #define DAILYMOTIONVIDEO_H
 
 #include "video.h"
+#include "videoregistry.h"
 #include <qdailymotion/resourcesrequest.h>
 
 class DailymotionVideo : public CTVideo
@@ -33,6 +34,7 @@ public:
     explicit DailymotionVideo(const QString &id, QObject *parent = 0);
     explicit DailymotionVideo(const QVariantMap &video, QObject *parent = 0);
     explicit DailymotionVideo(const DailymotionVideo *video, QObject *parent = 0);
+    ~DailymotionVideo();
     
     QString errorString() const;
     
@@ -57,13 +59,15 @@ private Q_SLOTS:
     void onVideoRequestFinished();
     void onFavouriteRequestFinished();
     void onUnfavouriteRequestFinished();
-    void onVideoUpdated(DailymotionVideo *video);
+    void onIdChanged();
     
 Q_SIGNALS:
     void favouriteChanged();
     void statusChanged(QDailymotion::ResourcesRequest::Status s);
 
 private:
+    static VideoRegistry<DailymotionVideo> registry;
+    
     QDailymotion::ResourcesRequest *m_request;
     
     bool m_favourite;
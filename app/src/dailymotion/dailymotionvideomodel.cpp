@@ -17,37 +17,47 @@
 #include "dailymotionvideomodel.h"
 #include "dailymotion.h"
 #include "dailymotionplaylist.h"
+#include "resources.h"
+#include "responsecache.h"
+#include "settings.h"
 #ifdef CUTETUBE_DEBUG
 #include <QDebug>
 #endif
 
 DailymotionVideoModel::DailymotionVideoModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QDailymotion::ResourcesRequest(this)),
-    m_hasMore(false)
+    m_prefetchRequest(0),
+    m_status(m_request->status()),
+    m_hasMore(false),
+    m_revalidating(false),
+    m_prefetchPage(0),
+    m_prefetchHasMore(false),
+    m_prefetchReady(false),
+    m_prefetchWaiting(false),
+    m_prefetchFailed(false),
+    m_prefetchQueued(false)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DurationRole] = "duration";
-    m_roles[FavouriteRole] = "favourited";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[ViewCountRole] = "viewCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
-    m_request->setClientId(Dailymotion::instance()->clientId());
-    m_request->setClientSecret(Dailymotion::instance()->clientSecret());
-    m_request->setAccessToken(Dailymotion::instance()->accessToken());
-    m_request->setRefreshToken(Dailymotion::instance()->refreshToken());
+    static RoleTable<DailymotionVideo> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTVideo::date);
+        roles.insert(DescriptionRole, "description", &CTVideo::description);
+        roles.insert(DurationRole, "duration", &CTVideo::duration);
+        roles.insert(FavouriteRole, "favourited", &DailymotionVideo::isFavourite);
+        roles.insert(IdRole, "id", &CTVideo::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTVideo::largeThumbnailUrl);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTVideo::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTVideo::title);
+        roles.insert(UrlRole, "url", &CTVideo::url);
+        roles.insert(UserIdRole, "userId", &CTVideo::userId);
+        roles.insert(UsernameRole, "username", &CTVideo::username);
+        roles.insert(ViewCountRole, "viewCount", &CTVideo::viewCount);
+    }
+    
+    setRoleTable(&roles);
     
-    connect(m_request, SIGNAL(accessTokenChanged(QString)), Dailymotion::instance(), SLOT(setAccessToken(QString)));
-    connect(m_request, SIGNAL(refreshTokenChanged(QString)), Dailymotion::instance(), SLOT(setRefreshToken(QString)));
+    initRequest(m_request);
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
 
@@ -56,15 +66,13 @@ QString DailymotionVideoModel::errorString() const {
 }
 
 QDailymotion::ResourcesRequest::Status DailymotionVideoModel::status() const {
-    return m_request->status();
+    if ((m_prefetchWaiting) && (isPrefetching())) {
+        return QDailymotion::ResourcesRequest::Loading;
+    }
+    
+    return m_status;
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> DailymotionVideoModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int DailymotionVideoModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -78,53 +86,32 @@ void DailymotionVideoModel::fetchMore(const QModelIndex &) {
         return;
     }
     
-    const int page = m_filters.value("page").toInt();
-    m_filters["page"] = (page > 0 ? page + 1 : 2);
-    m_request->list(m_resourcePath, m_filters, Dailymotion::VIDEO_FIELDS);
-    emit statusChanged(status());
-}
-
-QVariant DailymotionVideoModel::data(const QModelIndex &index, int role) const {
-    if (DailymotionVideo *video = get(index.row())) {
-        return video->property(m_roles[role]);
-    }
+    m_prefetchFailed = false;
     
-    return QVariant();
-}
-
-QMap<int, QVariant> DailymotionVideoModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (DailymotionVideo *video = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = video->property(iterator.value());
-        }
+    if (m_prefetchReady) {
+        loadPrefetchedResults();
+        return;
     }
     
-    return map;
-}
-
-QVariant DailymotionVideoModel::data(int row, const QByteArray &role) const {
-    if (DailymotionVideo *video = get(row)) {
-        return video->property(role);
+    if (isPrefetching()) {
+        m_prefetchWaiting = true;
+        emit statusChanged(status());
+        return;
     }
     
-    return QVariant();
+    const int page = m_filters.value("page").toInt();
+    m_filters["page"] = (page > 0 ? page + 1 : 2);
+    m_request->list(m_resourcePath, m_filters, Dailymotion::VIDEO_FIELDS);
+    m_status = m_request->status();
+    emit statusChanged(status());
 }
 
-QVariantMap DailymotionVideoModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (DailymotionVideo *video = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = video->property(role);
-        }
+QVariant DailymotionVideoModel::data(const QModelIndex &index, int role) const {
+    if (get(index.row())) {
+        prefetchIfNeeded(index.row());
     }
     
-    return map;
+    return RoleListModel::data(index, role);
 }
 
 DailymotionVideo* DailymotionVideoModel::get(int row) const {
@@ -143,7 +130,15 @@ void DailymotionVideoModel::list(const QString &resourcePath, const QVariantMap
     clear();
     m_resourcePath = resourcePath;
     m_filters = filters;
-    m_request->list(resourcePath, filters, Dailymotion::VIDEO_FIELDS);
+    
+    if (loadCachedResult()) {
+        m_status = QDailymotion::ResourcesRequest::Ready;
+    }
+    else {
+        m_request->list(resourcePath, filters, Dailymotion::VIDEO_FIELDS);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
     
     disconnect(Dailymotion::instance(), 0, this, 0);
@@ -163,6 +158,9 @@ void DailymotionVideoModel::list(const QString &resourcePath, const QVariantMap
 }
 
 void DailymotionVideoModel::clear() {
+    cancelPrefetch();
+    m_prefetchFailed = false;
+    
     if (!m_items.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
@@ -174,15 +172,150 @@ void DailymotionVideoModel::clear() {
 }
 
 void DailymotionVideoModel::cancel() {
+    cancelPrefetch();
     m_request->cancel();
 }
 
 void DailymotionVideoModel::reload() {
     clear();
+    m_cacheKey = cacheKey();
     m_request->list(m_resourcePath, m_filters, Dailymotion::VIDEO_FIELDS);
+    m_status = m_request->status();
+    emit statusChanged(status());
+}
+
+void DailymotionVideoModel::initRequest(QDailymotion::ResourcesRequest *request) {
+    request->setClientId(Dailymotion::instance()->clientId());
+    request->setClientSecret(Dailymotion::instance()->clientSecret());
+    request->setAccessToken(Dailymotion::instance()->accessToken());
+    request->setRefreshToken(Dailymotion::instance()->refreshToken());
+    
+    connect(request, SIGNAL(accessTokenChanged(QString)), Dailymotion::instance(), SLOT(setAccessToken(QString)));
+    connect(request, SIGNAL(refreshTokenChanged(QString)), Dailymotion::instance(), SLOT(setRefreshToken(QString)));
+}
+
+QString DailymotionVideoModel::cacheKey() const {
+    return ResponseCache::cacheKey(Resources::DAILYMOTION, m_resourcePath, m_filters, QVariantMap(), Dailymotion::instance()->userId());
+}
+
+bool DailymotionVideoModel::loadCachedResult() {
+    bool stale = false;
+    m_cacheKey = cacheKey();
+    const QVariantMap result = ResponseCache::instance()->result(m_cacheKey, &stale).toMap();
+    
+    if (result.isEmpty()) {
+        return false;
+    }
+    
+    loadResult(result);
+    
+    if (stale) {
+        m_revalidating = true;
+        return false;
+    }
+    
+    m_cacheKey = QString();
+    return true;
+}
+
+void DailymotionVideoModel::loadResult(const QVariantMap &result) {
+    m_hasMore = result.value("has_more").toBool();
+    const QVariantList list = result.value("list").toList();
+    
+    if (!list.isEmpty()) {
+        loadResults(list);
+    }
+}
+
+void DailymotionVideoModel::loadResults(const QVariantList &list) {
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
+    
+    foreach (QVariant item, list) {
+        m_items << new DailymotionVideo(item.toMap(), this);
+    }
+
+    endInsertRows();
+    emit countChanged(rowCount());
+}
+
+bool DailymotionVideoModel::isPrefetching() const {
+    return (m_prefetchRequest) && (m_prefetchRequest->status() == QDailymotion::ResourcesRequest::Loading);
+}
+
+void DailymotionVideoModel::prefetchIfNeeded(int row) const {
+    if ((m_prefetchReady) || (m_prefetchFailed) || (m_prefetchQueued) || (!m_hasMore) || (isPrefetching())) {
+        return;
+    }
+    
+    const int threshold = Settings::instance()->prefetchThreshold();
+    
+    if ((threshold > 0) && (row >= m_items.size() - threshold)) {
+        m_prefetchQueued = true;
+        QMetaObject::invokeMethod(const_cast<DailymotionVideoModel*>(this), "prefetch", Qt::QueuedConnection);
+    }
+}
+
+void DailymotionVideoModel::prefetch() {
+    m_prefetchQueued = false;
+    
+    if ((m_prefetchReady) || (!m_hasMore) || (isPrefetching()) || (status() == QDailymotion::ResourcesRequest::Loading)) {
+        return;
+    }
+    
+    if (!m_prefetchRequest) {
+        m_prefetchRequest = new QDailymotion::ResourcesRequest(this);
+        initRequest(m_prefetchRequest);
+        connect(m_prefetchRequest, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+    }
+    
+    const int page = m_filters.value("page").toInt();
+    m_prefetchPage = (page > 0 ? page + 1 : 2);
+    QVariantMap filters = m_filters;
+    filters["page"] = m_prefetchPage;
+    m_prefetchRequest->list(m_resourcePath, filters, Dailymotion::VIDEO_FIELDS);
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "DailymotionVideoModel::prefetch" << m_resourcePath << m_prefetchPage;
+#endif
+}
+
+void DailymotionVideoModel::cancelPrefetch() {
+    m_prefetchWaiting = false;
+    m_prefetchReady = false;
+    m_prefetchResults.clear();
+    
+    if (m_prefetchRequest) {
+        m_prefetchRequest->cancel();
+    }
+}
+
+void DailymotionVideoModel::loadPrefetchedResults() {
+    const QVariantList list = m_prefetchResults;
+    m_filters["page"] = m_prefetchPage;
+    m_hasMore = m_prefetchHasMore;
+    m_prefetchResults.clear();
+    m_prefetchReady = false;
+    m_prefetchWaiting = false;
+    
+    if (!list.isEmpty()) {
+        loadResults(list);
+    }
+    
     emit statusChanged(status());
 }
 
+void DailymotionVideoModel::finishPrefetch() {
+    if (m_prefetchWaiting) {
+        m_prefetchWaiting = false;
+        
+        if (m_prefetchReady) {
+            loadPrefetchedResults();
+        }
+        else {
+            fetchMore();
+        }
+    }
+}
+
 void DailymotionVideoModel::append(DailymotionVideo *video) {
     beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
     m_items << video;
@@ -213,25 +346,50 @@ void DailymotionVideoModel::onRequestFinished() {
         QVariantMap result = m_request->result().toMap();
         
         if (!result.isEmpty()) {
-            m_hasMore = result.value("has_more").toBool();
-            QVariantList list = result.value("list").toList();
-
-            beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
-    
-            foreach (QVariant item, list) {
-                m_items << new DailymotionVideo(item.toMap(), this);
+            const bool changed = (!m_revalidating) || (result != ResponseCache::instance()->result(m_cacheKey).toMap());
+            
+            if (!m_cacheKey.isEmpty()) {
+                ResponseCache::instance()->insert(m_cacheKey, result,
+                                                  ResponseCache::timeToLive(m_resourcePath, m_filters));
+            }
+            
+            if (changed) {
+                if (m_revalidating) {
+                    clear();
+                }
+                
+                loadResult(result);
             }
-
-            endInsertRows();
-            emit countChanged(rowCount());
         }
     }
     
+    // A failed revalidation keeps showing the cached page
+    m_status = m_revalidating ? QDailymotion::ResourcesRequest::Ready : m_request->status();
+    m_cacheKey = QString();
+    m_revalidating = false;
     emit statusChanged(status());
 }
 
+void DailymotionVideoModel::onPrefetchRequestFinished() {
+    m_prefetchFailed = (m_prefetchRequest->status() == QDailymotion::ResourcesRequest::Failed);
+    
+    if (m_prefetchRequest->status() == QDailymotion::ResourcesRequest::Ready) {
+        QVariantMap result = m_prefetchRequest->result().toMap();
+        
+        if (!result.isEmpty()) {
+            m_prefetchHasMore = result.value("has_more").toBool();
+            m_prefetchResults = result.value("list").toList();
+            m_prefetchReady = true;
+        }
+    }
+    
+    finishPrefetch();
+}
+
 void DailymotionVideoModel::onVideoAddedToPlaylist(DailymotionVideo *video, DailymotionPlaylist *playlist) {
     if (m_resourcePath.section('/', -2, -2) == playlist->id()) {
+        ResponseCache::instance()->remove(cacheKey());
+        
         insert(0, new DailymotionVideo(video, this));
     }
 #ifdef CUTETUBE_DEBUG
@@ -241,6 +399,8 @@ void DailymotionVideoModel::onVideoAddedToPlaylist(DailymotionVideo *video, Dail
 
 void DailymotionVideoModel::onVideoRemovedFromPlaylist(DailymotionVideo *video, DailymotionPlaylist *playlist) {
     if (m_resourcePath.section('/', -2, -2) == playlist->id()) {
+        ResponseCache::instance()->remove(cacheKey());
+        
         QModelIndexList list = match(index(0), IdRole, video->id(), 1, Qt::MatchExactly);
         
         if (!list.isEmpty()) {
@@ -253,6 +413,8 @@ void DailymotionVideoModel::onVideoRemovedFromPlaylist(DailymotionVideo *video,
 }
 
 void DailymotionVideoModel::onVideoFavourited(DailymotionVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     insert(0, new DailymotionVideo(video, this));
 #ifdef CUTETUBE_DEBUG
     qDebug() << "DailymotionVideoModel::onVideoFavourited" << video->id();
@@ -260,6 +422,8 @@ void DailymotionVideoModel::onVideoFavourited(DailymotionVideo *video) {
 }
 
 void DailymotionVideoModel::onVideoUnfavourited(DailymotionVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     QModelIndexList list = match(index(0), IdRole, video->id(), 1, Qt::MatchExactly);
     
     if (!list.isEmpty()) {
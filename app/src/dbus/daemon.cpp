@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "daemon.h"
+#include "dailymotion.h"
+#include "database.h"
+#include "dbusservice.h"
+#include "resourcesplugins.h"
+#include "settings.h"
+#include "transfers.h"
+#include "vimeo.h"
+#include "youtube.h"
+#include <QCoreApplication>
+#ifdef Q_WS_MAEMO_5
+#include <QSsl>
+#include <QSslConfiguration>
+#endif
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int signalFds[2];
+
+static void handleSignal(int) {
+    const char c = 1;
+    const ssize_t written = ::write(signalFds[0], &c, sizeof(c));
+    Q_UNUSED(written);
+}
+
+// Quits through the event loop, so that aboutToQuit() stores transfers and settings
+static void installSignalHandlers(QCoreApplication *app) {
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFds) != 0) {
+        return;
+    }
+    
+    QSocketNotifier *notifier = new QSocketNotifier(signalFds[1], QSocketNotifier::Read, app);
+    QObject::connect(notifier, SIGNAL(activated(int)), app, SLOT(quit()));
+    
+    struct sigaction action;
+    action.sa_handler = handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGTERM, &action, 0);
+    sigaction(SIGINT, &action, 0);
+}
+#endif
+
+bool isDaemonMode(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp(argv[i], "--daemon") == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+int execDaemon(int &argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("cuteTube2");
+    app.setApplicationName("cuteTube2");
+#ifdef Q_WS_MAEMO_5
+    QSslConfiguration config = QSslConfiguration::defaultConfiguration();
+    config.setProtocol(QSsl::TlsV1);
+    QSslConfiguration::setDefaultConfiguration(config);
+#endif
+    Settings settings;
+    Dailymotion dailymotion;
+    DBusService dbus;
+    ResourcesPlugins plugins;
+    Transfers transfers;
+    Vimeo vimeo;
+    YouTube youtube;
+    
+    initDatabase();
+    plugins.load();
+    settings.setNetworkProxy();
+    transfers.restoreTransfers();
+#ifdef Q_OS_UNIX
+    installSignalHandlers(&app);
+#endif
+    return app.exec();
+}
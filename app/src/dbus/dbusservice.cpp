@@ -16,6 +16,8 @@
 
 #include "dbusservice.h"
 #include "resources.h"
+#include "settings.h"
+#include "transfers.h"
 #include <QDBusConnection>
 #include <QStringList>
 #ifdef CUTETUBE_DEBUG
@@ -55,3 +57,117 @@ bool DBusService::showResource(const QStringList &url) {
 
     return false;
 }
+
+int DBusService::maximumDownloadSpeed() {
+    return Settings::instance()->maximumDownloadSpeed();
+}
+
+int DBusService::maximumDownloadSpeed(const QString &service) {
+    return Settings::instance()->maximumDownloadSpeed(service);
+}
+
+bool DBusService::setMaximumDownloadSpeed(int speed) {
+    if (speed < 0) {
+        return false;
+    }
+    
+    Settings::instance()->setMaximumDownloadSpeed(speed);
+    return true;
+}
+
+bool DBusService::setMaximumDownloadSpeed(const QString &service, int speed) {
+    if ((service.isEmpty()) || (speed < 0)) {
+        return false;
+    }
+    
+    Settings::instance()->setMaximumDownloadSpeed(service, speed);
+    return true;
+}
+
+QString DBusService::enqueue(const QString &url, const QString &title) {
+    const QVariantMap resource = Resources::getResourceFromUrl(url);
+    
+    if (resource.value("type") != Resources::VIDEO) {
+        return QString();
+    }
+    
+    // If there is no default format, the transfer selects the highest resolution stream
+    const QString service = resource.value("service").toString();
+    return enqueue(service, resource.value("id").toString(), Settings::instance()->defaultDownloadFormat(service),
+                   title, QString());
+}
+
+QString DBusService::enqueue(const QString &service, const QString &resourceId, const QString &streamId,
+                             const QString &title, const QString &category) {
+    if ((service.isEmpty()) || (resourceId.isEmpty()) || (title.isEmpty())) {
+        return QString();
+    }
+    
+    const QString c = category.isEmpty() ? Settings::instance()->defaultCategory() : category;
+    Transfer *transfer = Transfers::instance()->addDownloadTransfer(service, resourceId, streamId, QUrl(), title, c);
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "DBusService::enqueue" << service << resourceId << streamId << transfer->id();
+#endif
+    transfer->queue();
+    return transfer->id();
+}
+
+bool DBusService::pause() {
+    return Transfers::instance()->pause();
+}
+
+bool DBusService::pause(const QString &id) {
+    return Transfers::instance()->pause(id);
+}
+
+bool DBusService::resume() {
+    return Transfers::instance()->start();
+}
+
+bool DBusService::resume(const QString &id) {
+    return Transfers::instance()->start(id);
+}
+
+bool DBusService::cancel(const QString &id) {
+    return Transfers::instance()->cancel(id);
+}
+
+bool DBusService::prioritize(const QString &id, int priority) {
+    if ((priority < Transfer::HighPriority) || (priority > Transfer::LowPriority)) {
+        return false;
+    }
+    
+    if (Transfer *transfer = Transfers::instance()->get(id)) {
+        transfer->setPriority(Transfer::Priority(priority));
+        return true;
+    }
+    
+    return false;
+}
+
+QVariantList DBusService::list() {
+    QVariantList transfers;
+    
+    for (int i = 0; i < Transfers::instance()->count(); i++) {
+        if (Transfer *transfer = Transfers::instance()->get(i)) {
+            QVariantMap map;
+            map["id"] = transfer->id();
+            map["service"] = transfer->service();
+            map["resourceId"] = transfer->resourceId();
+            map["title"] = transfer->title();
+            map["category"] = transfer->category();
+            map["priority"] = int(transfer->priority());
+            map["status"] = int(transfer->status());
+            map["statusString"] = transfer->statusString();
+            map["errorString"] = transfer->errorString();
+            map["progress"] = transfer->progress();
+            map["bytesTransferred"] = transfer->bytesTransferred();
+            map["size"] = transfer->size();
+            map["speed"] = transfer->speed();
+            map["eta"] = transfer->eta();
+            transfers << map;
+        }
+    }
+    
+    return transfers;
+}
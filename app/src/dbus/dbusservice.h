@@ -18,6 +18,7 @@
 #define DBUSSERVICE_H
 
 #include <QObject>
+#include <QVariantList>
 #include <QVariantMap>
 
 class DBusService : public QObject
@@ -35,6 +36,22 @@ public Q_SLOTS:
     bool showResource(const QString &url);
     bool showResource(const QStringList &url);
     
+    int maximumDownloadSpeed();
+    int maximumDownloadSpeed(const QString &service);
+    bool setMaximumDownloadSpeed(int speed);
+    bool setMaximumDownloadSpeed(const QString &service, int speed);
+    
+    QString enqueue(const QString &url, const QString &title);
+    QString enqueue(const QString &service, const QString &resourceId, const QString &streamId, const QString &title,
+                    const QString &category);
+    bool pause();
+    bool pause(const QString &id);
+    bool resume();
+    bool resume(const QString &id);
+    bool cancel(const QString &id);
+    bool prioritize(const QString &id, int priority);
+    QVariantList list();
+    
 Q_SIGNALS:
     void resourceRequested(const QVariantMap &resource);
     
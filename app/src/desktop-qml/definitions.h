@@ -26,9 +26,17 @@
 #endif
 
 static const int MAX_CONCURRENT_TRANSFERS = 4;
+static const int MAX_ADAPTIVE_CONCURRENT_TRANSFERS = 8;
+static const int MAX_TRANSFERS_PER_HOST = 3;
+static const int MAX_DOWNLOAD_SEGMENTS = 8;
+static const qint64 MIN_DOWNLOAD_SEGMENT_SIZE = 1024 * 1024;
 static const int MAX_REDIRECTS = 8;
 
+static const int MAX_PLUGIN_WORKERS = 4;
+static const int PLUGIN_WORKER_TIMEOUT = 60000;
+
 static const int MAX_RESULTS = 20;
+static const qint64 RESPONSE_CACHE_DISK_SIZE = 16 * 1024 * 1024;
 
 static const QRegExp ILLEGAL_FILENAME_CHARS_RE("[\"@&~=\\/:?#!|<>*^]");
 
@@ -19,6 +19,7 @@
 #include "clipboard.h"
 #include "concurrenttransfersmodel.h"
 #include "cookiejar.h"
+#include "daemon.h"
 #include "dailymotion.h"
 #include "dailymotionaccountmodel.h"
 #include "dailymotioncategorymodel.h"
@@ -160,6 +161,10 @@ inline void registerTypes() {
 }
 
 Q_DECL_EXPORT int main(int argc, char *argv[]) {
+    if (isDaemonMode(argc, argv)) {
+        return execDaemon(argc, argv);
+    }
+    
     QApplication app(argc, argv);
     app.setOrganizationName("cuteTube2");
     app.setApplicationName("cuteTube2");
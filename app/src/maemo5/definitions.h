@@ -26,9 +26,23 @@
 #endif
 
 static const int MAX_CONCURRENT_TRANSFERS = 4;
+static const int MAX_ADAPTIVE_CONCURRENT_TRANSFERS = 6;
+static const int MAX_TRANSFERS_PER_HOST = 2;
+static const int MAX_DOWNLOAD_SEGMENTS = 8;
+static const qint64 MIN_DOWNLOAD_SEGMENT_SIZE = 1024 * 1024;
 static const int MAX_REDIRECTS = 8;
 
+static const int MAX_PLUGIN_WORKERS = 4;
+static const int PLUGIN_WORKER_TIMEOUT = 60000;
+
 static const int MAX_RESULTS = 20;
+static const qint64 RESPONSE_CACHE_DISK_SIZE = 4 * 1024 * 1024;
+
+static const int IMAGE_CACHE_MEMORY = 8 * 1024 * 1024;
+static const qint64 IMAGE_CACHE_DISK_SIZE = 32 * 1024 * 1024;
+static const qint64 IMAGE_CACHE_MAX_AGE = 24 * 60 * 60 * 1000;
+static const qint64 IMAGE_CACHE_RETRY_INTERVAL = 60 * 1000;
+static const int MAX_IMAGE_DECODERS = 2;
 
 static const QRegExp ILLEGAL_FILENAME_CHARS_RE("[\"@&~=\\/:?#!|<>*^]");
 
@@ -41,6 +55,8 @@ static const QString STORAGE_PATH(QStandardPaths::writableLocation(QStandardPath
 static const QStringList PLUGIN_PATHS = QStringList() << "/opt/cutetube2/plugins/"
                                                       << QStandardPaths::writableLocation(QStandardPaths::ConfigLocation)
                                                          + "/cuteTube2/plugins/";
+static const QString IMAGE_CACHE_PATH(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                                      + "/cuteTube2/images/");
 #else
 static const QString DATABASE_PATH(QDesktopServices::storageLocation(QDesktopServices::HomeLocation) + "/.config/cuteTube2/");
 static const QString DOWNLOAD_PATH("/home/user/MyDocs/cuteTube2/");
@@ -48,6 +64,8 @@ static const QString STORAGE_PATH(QDesktopServices::storageLocation(QDesktopServ
 static const QStringList PLUGIN_PATHS = QStringList() << "/opt/cutetube2/plugins/"
                                                       << QDesktopServices::storageLocation(QDesktopServices::HomeLocation)
                                                          + "/.config/cuteTube2/plugins/";
+static const QString IMAGE_CACHE_PATH(QDesktopServices::storageLocation(QDesktopServices::HomeLocation)
+                                      + "/.cache/cuteTube2/images/");
 #endif
 
 #endif // DEFINITIONS_H
@@ -14,114 +14,442 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #include "imagecache.h"
-#include <QNetworkAccessManager>
+#include "definitions.h"
+#include "networkaccessmanager.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QImageReader>
+#include <QMutex>
 #include <QNetworkReply>
 #include <QThread>
+#include <QThreadPool>
+#include <utime.h>
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
 
-class CachedImage
-{
+static const int MAX_REQUESTS = 8;
+
+static const quint32 IMAGE_CACHE_MAGIC = 0x43544943;
+
+static qint64 diskUsage = -1;
+static QMutex diskMutex;
+
+// Entries are keyed by URL rather than by content, since the validators stored with them are per URL
+static QString entryPath(const QUrl &url) {
+    return IMAGE_CACHE_PATH + QString::fromLatin1(QCryptographicHash::hash(url.toEncoded(),
+                                                                           QCryptographicHash::Sha1).toHex());
+}
 
-public:
-    explicit CachedImage(const QUrl &u) :
-        url(u)
-    {
+static bool readEntry(const QString &path, qint64 &validated, QByteArray &eTag, QByteArray &lastModified,
+                      QByteArray &data) {
+    QFile file(path);
+    
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
     }
     
-    const QUrl url;
-    QImage image;    
-};
-
-QThread* ImageCache::thread = 0;
-QQueue<QUrl> ImageCache::queue;
-QCache<QUrl, CachedImage> ImageCache::cache;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    quint32 magic = 0;
+    stream >> magic >> validated >> eTag >> lastModified >> data;
+    return (magic == IMAGE_CACHE_MAGIC) && (stream.status() == QDataStream::Ok);
+}
 
-int ImageCache::requestCount = 0;
-int ImageCache::refCount = 0;
+static void expireEntries() {
+    QDir dir(IMAGE_CACHE_PATH);
+    
+    if (diskUsage < 0) {
+        diskUsage = 0;
+        
+        foreach (const QFileInfo &info, dir.entryInfoList(QDir::Files)) {
+            diskUsage += info.size();
+        }
+    }
+    
+    if (diskUsage <= IMAGE_CACHE_DISK_SIZE) {
+        return;
+    }
+    
+    foreach (const QFileInfo &info, dir.entryInfoList(QDir::Files, QDir::Time | QDir::Reversed)) {
+        if (diskUsage <= IMAGE_CACHE_DISK_SIZE * 3 / 4) {
+            break;
+        }
+        
+        if (QFile::remove(info.absoluteFilePath())) {
+            diskUsage -= info.size();
+        }
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "expireEntries: Disk usage" << diskUsage;
+#endif
+}
 
-static const int MAX_REQUESTS = 8;
+static void writeEntry(const QString &path, qint64 validated, const QByteArray &eTag, const QByteArray &lastModified,
+                       const QByteArray &data) {
+    QDir().mkpath(IMAGE_CACHE_PATH);
+    QFile file(path);
+    const qint64 oldSize = file.size();
+    
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << IMAGE_CACHE_MAGIC << validated << eTag << lastModified << data;
+    file.close();
+    
+    if (diskUsage >= 0) {
+        diskUsage += file.size() - oldSize;
+    }
+    
+    expireEntries();
+}
 
 ImageCache::ImageCache() :
-    QObject(),
-    m_manager(new QNetworkAccessManager)
+    QObject()
 {
-    refCount++;
+    connect(ImageLoader::instance(), SIGNAL(imagesLoaded(QStringList)), this, SLOT(onImagesLoaded(QStringList)));
+}
+
+ImageCache::~ImageCache() {}
+
+QImage ImageCache::image(const QUrl &url, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                         Qt::TransformationMode transformationMode) {
+    if (url.isEmpty()) {
+        return QImage();
+    }
+    
+    const ImageVariant variant(url, size, aspectRatioMode, transformationMode);
     
-    if (!thread) {
-        thread = new QThread;
-        thread->start();
+    if (QImage *image = ImageLoader::instance()->image(variant.key)) {
+        return *image;
     }
     
-    moveToThread(thread);
+    if ((!m_pending.contains(variant.key)) && (ImageLoader::instance()->load(url, variant))) {
+        m_pending.insert(variant.key);
+    }
+    
+    return QImage();
 }
 
-ImageCache::~ImageCache() {
-    delete m_manager;
-    m_manager = 0;
-    refCount--;
+void ImageCache::onImagesLoaded(const QStringList &keys) {
+    bool ready = false;
     
-    if (refCount == 0) {
-        thread->quit();
-        thread->deleteLater();
-        thread = 0;
+    foreach (const QString &key, keys) {
+        if (m_pending.remove(key)) {
+            ready = true;
+        }
+    }
+    
+    if (ready) {
+        emit imageReady();
     }
 }
 
-QImage ImageCache::image(const QUrl &url, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
-                         Qt::TransformationMode transformationMode) {
-    if (CachedImage *ci = cache.object(url)) {
-        return (!size.isEmpty())
-               && (!ci->image.isNull()) ? ci->image.scaled(size, aspectRatioMode, transformationMode)
-                                        : ci->image;
+ImageLoader* ImageLoader::self = 0;
+
+ImageLoader::ImageLoader() :
+    QObject(QCoreApplication::instance()),
+    m_manager(NetworkAccessManager::instance()),
+    m_pool(new QThreadPool(this))
+{
+    qRegisterMetaType<ImageJob>("ImageJob");
+    m_images.setMaxCost(IMAGE_CACHE_MEMORY);
+    m_pool->setMaxThreadCount(qBound(1, QThread::idealThreadCount(), MAX_IMAGE_DECODERS));
+}
+
+ImageLoader::~ImageLoader() {
+    m_pool->waitForDone();
+    
+    if (self == this) {
+        self = 0;
+    }
+}
+
+ImageLoader* ImageLoader::instance() {
+    if (!self) {
+        self = new ImageLoader;
     }
     
-    cache.insert(url, new CachedImage(url));
+    return self;
+}
+
+QImage* ImageLoader::image(const QString &key) const {
+    return m_images.object(key);
+}
+
+bool ImageLoader::load(const QUrl &url, const ImageVariant &variant) {
+    if (m_failed.contains(url)) {
+        if (QDateTime::currentMSecsSinceEpoch() - m_failed.value(url) < IMAGE_CACHE_RETRY_INTERVAL) {
+            return false;
+        }
+        
+        m_failed.remove(url);
+    }
+    
+    QList<ImageVariant> &variants = m_pending[url];
+    
+    foreach (const ImageVariant &v, variants) {
+        if (v.key == variant.key) {
+            return true;
+        }
+    }
+    
+    variants << variant;
     
-    if (requestCount < MAX_REQUESTS) {
-        getImage(url);
+    if (!m_active.contains(url)) {
+        startJob(url);
+    }
+    
+    return true;
+}
+
+void ImageLoader::startJob(const QUrl &url) {
+    ImageJob job;
+    job.url = url;
+    job.variants = m_pending.take(url);
+    m_active.insert(url);
+    m_pool->start(new ImageDecoder(this, job));
+}
+
+void ImageLoader::startRequest(const ImageJob &job) {
+    ImageJob request = job;
+    request.variants.clear();
+    m_queue.enqueue(request);
+    nextRequest();
+}
+
+void ImageLoader::nextRequest() {
+    while ((!m_queue.isEmpty()) && (m_requests.size() < MAX_REQUESTS)) {
+        const ImageJob job = m_queue.dequeue();
+        QNetworkRequest request(job.url);
+        
+        if (job.found) {
+            if (!job.eTag.isEmpty()) {
+                request.setRawHeader("If-None-Match", job.eTag);
+            }
+            
+            if (!job.lastModified.isEmpty()) {
+                request.setRawHeader("If-Modified-Since", job.lastModified);
+            }
+        }
+        
+        QNetworkReply *reply = m_manager->get(request);
+        m_requests[reply] = job;
+        connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+    }
+}
+
+void ImageLoader::insertImages(const ImageJob &job) {
+    QStringList keys;
+    
+    bool failed = false;
+    
+    foreach (const ImageVariant &variant, job.variants) {
+        if (variant.image.isNull()) {
+            failed = true;
+        }
+        else {
+            m_images.insert(variant.key, new QImage(variant.image), variant.image.byteCount());
+        }
+        
+        keys << variant.key;
+    }
+    
+    if (failed) {
+        m_failed[job.url] = QDateTime::currentMSecsSinceEpoch();
     }
     else {
-        queue.enqueue(url);
+        m_failed.remove(job.url);
     }
     
-    return QImage();
+    emit imagesLoaded(keys);
 }
 
-void ImageCache::getImage(const QUrl &url) {
-    requestCount++;
-    ImageRequest *request = new ImageRequest(m_manager, url);
-    connect(request, SIGNAL(finished(ImageRequest*)), this, SLOT(onRequestFinished(ImageRequest*)));
+void ImageLoader::onJobFinished(const ImageJob &job) {
+    if ((job.found) || (!job.revalidate)) {
+        insertImages(job);
+    }
+    else {
+        m_pending[job.url] = job.variants + m_pending.value(job.url);
+    }
+    
+    if (job.revalidate) {
+        if (job.found) {
+            QList<ImageVariant> &variants = m_variants[job.url];
+            
+            foreach (ImageVariant variant, job.variants) {
+                variant.image = QImage();
+                variants << variant;
+            }
+        }
+        
+        startRequest(job);
+    }
+    else {
+        m_active.remove(job.url);
+        
+        if (m_pending.contains(job.url)) {
+            startJob(job.url);
+        }
+    }
 }
 
-void ImageCache::onRequestFinished(ImageRequest *request) {    
-    if (CachedImage *ci = cache.object(request->url)) {
-        QImage image;
-        image.loadFromData(request->reply->readAll());
-        ci->image = image;
-        emit imageReady();
+void ImageLoader::onReplyFinished() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    
+    if (!reply) {
+        return;
     }
     
-    request->deleteLater();
-    requestCount--;
+    ImageJob job = m_requests.take(reply);
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QByteArray data = (reply->error() == QNetworkReply::NoError) && (status != 304) ? reply->readAll()
+                                                                                          : QByteArray();
     
-    if ((!queue.isEmpty()) && (requestCount < MAX_REQUESTS)) {
-        getImage(queue.dequeue());
+    if (!data.isEmpty()) {
+        job.data = data;
+        job.eTag = reply->rawHeader("ETag");
+        job.lastModified = reply->rawHeader("Last-Modified");
+        job.variants = m_pending.take(job.url);
+        
+        if (job.found) {
+            job.variants += m_variants.take(job.url);
+        }
+        
+        job.found = false;
+        job.revalidate = false;
+        m_pool->start(new ImageDecoder(this, job));
     }
+    else {
+        if (status == 304) {
+            m_pool->start(new ImageDecoder(this, job, ImageDecoder::Touch));
+        }
+        else if (!job.found) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "ImageLoader::onReplyFinished: Error" << job.url << reply->errorString();
+#endif
+            job.variants = m_pending.take(job.url);
+            insertImages(job);
+        }
+        
+        m_variants.remove(job.url);
+        m_active.remove(job.url);
+        
+        if (m_pending.contains(job.url)) {
+            startJob(job.url);
+        }
+    }
+    
+    reply->deleteLater();
+    nextRequest();
 }
 
-ImageRequest::ImageRequest(QNetworkAccessManager *manager, const QUrl &u) :
-    QObject()
+ImageDecoder::ImageDecoder(ImageLoader *loader, const ImageJob &job, Task task) :
+    QRunnable(),
+    m_loader(loader),
+    m_job(job),
+    m_task(task)
 {
-    url = u;
-    reply = manager->get(QNetworkRequest(url));
-    connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
 }
 
-ImageRequest::~ImageRequest() {
-    reply->deleteLater();
-    reply = 0;
+void ImageDecoder::run() {
+    if (m_task == Touch) {
+        touch();
+    }
+    else {
+        process();
+    }
+}
+
+void ImageDecoder::process() {
+    ImageJob &result = m_job;
+    const QString path = entryPath(result.url);
+    const bool fromNetwork = !result.data.isEmpty();
+    
+    if (!fromNetwork) {
+        QMutexLocker locker(&diskMutex);
+        qint64 validated = 0;
+        
+        if (readEntry(path, validated, result.eTag, result.lastModified, result.data)) {
+            utime(QFile::encodeName(path).constData(), 0);
+            result.revalidate = QDateTime::currentMSecsSinceEpoch() - validated > IMAGE_CACHE_MAX_AGE;
+        }
+        else {
+            result.data.clear();
+            result.revalidate = true;
+        }
+    }
+    
+    if (!result.data.isEmpty()) {
+        QBuffer buffer(&result.data);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer);
+        
+        if (result.variants.size() == 1) {
+            const ImageVariant &variant = result.variants.first();
+            const QSize size = reader.size();
+            
+            if ((!variant.size.isEmpty()) && (size.isValid())) {
+                const QSize scaledSize = size.scaled(variant.size, variant.aspectRatioMode);
+                
+                if ((scaledSize.width() < size.width()) && (scaledSize.height() < size.height())) {
+                    reader.setScaledSize(scaledSize);
+                }
+            }
+        }
+        
+        const QImage image = reader.read();
+        
+        if (!image.isNull()) {
+            result.found = true;
+            
+            for (int i = 0; i < result.variants.size(); i++) {
+                ImageVariant &variant = result.variants[i];
+                
+                if ((variant.size.isEmpty()) || (image.size() == image.size().scaled(variant.size,
+                                                                                      variant.aspectRatioMode))) {
+                    variant.image = image;
+                }
+                else {
+                    variant.image = image.scaled(variant.size, variant.aspectRatioMode, variant.transformationMode);
+                }
+            }
+            
+            if (fromNetwork) {
+                QMutexLocker locker(&diskMutex);
+                writeEntry(path, QDateTime::currentMSecsSinceEpoch(), result.eTag, result.lastModified, result.data);
+            }
+        }
+        else if (!fromNetwork) {
+            QMutexLocker locker(&diskMutex);
+            QFile::remove(path);
+            result.revalidate = true;
+        }
+    }
+    
+    result.data.clear();
+    QMetaObject::invokeMethod(m_loader, "onJobFinished", Qt::QueuedConnection, Q_ARG(ImageJob, result));
 }
 
-void ImageRequest::onReplyFinished() {
-    emit finished(this);
+void ImageDecoder::touch() {
+    QMutexLocker locker(&diskMutex);
+    const QString path = entryPath(m_job.url);
+    qint64 validated = 0;
+    QByteArray eTag;
+    QByteArray lastModified;
+    QByteArray data;
+    
+    if (readEntry(path, validated, eTag, lastModified, data)) {
+        writeEntry(path, QDateTime::currentMSecsSinceEpoch(), eTag, lastModified, data);
+    }
 }
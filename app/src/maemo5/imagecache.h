@@ -14,20 +14,67 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #ifndef IMAGECACHE_H
 #define IMAGECACHE_H
 
-#include <QQueue>
 #include <QCache>
+#include <QHash>
 #include <QImage>
+#include <QMetaType>
+#include <QQueue>
+#include <QRunnable>
+#include <QSet>
+#include <QStringList>
 #include <QUrl>
 
-class CachedImage;
-class ImageRequest;
-class QThread;
+class QThreadPool;
 class QNetworkAccessManager;
 class QNetworkReply;
 
+struct ImageVariant
+{
+    ImageVariant() :
+        aspectRatioMode(Qt::KeepAspectRatio),
+        transformationMode(Qt::SmoothTransformation)
+    {
+    }
+    
+    ImageVariant(const QUrl &url, const QSize &s, Qt::AspectRatioMode aspect, Qt::TransformationMode transform) :
+        size(s),
+        aspectRatioMode(aspect),
+        transformationMode(transform)
+    {
+        key = QString("%1x%2/%3/%4/%5").arg(size.width()).arg(size.height()).arg(aspectRatioMode)
+                                       .arg(transformationMode).arg(url.toString());
+    }
+    
+    QString key;
+    QSize size;
+    Qt::AspectRatioMode aspectRatioMode;
+    Qt::TransformationMode transformationMode;
+    QImage image;
+};
+
+struct ImageJob
+{
+    ImageJob() :
+        found(false),
+        revalidate(false)
+    {
+    }
+    
+    QUrl url;
+    QByteArray data;
+    QByteArray eTag;
+    QByteArray lastModified;
+    QList<ImageVariant> variants;
+    bool found;
+    bool revalidate;
+};
+
+Q_DECLARE_METATYPE(ImageJob)
+
 class ImageCache : public QObject
 {
     Q_OBJECT
@@ -40,43 +87,79 @@ public:
                  Qt::TransformationMode transformatioMode = Qt::SmoothTransformation);
     
 private Q_SLOTS:
-    void onRequestFinished(ImageRequest *request);
+    void onImagesLoaded(const QStringList &keys);
     
 Q_SIGNALS:
     void imageReady();
     
 private:
-    void getImage(const QUrl &url);
-    
-    static QThread *thread;
-    
-    static QQueue<QUrl> queue;
-    static QCache<QUrl, CachedImage> cache;
-    
-    static int requestCount;
-    static int refCount;
-    
-    QNetworkAccessManager *m_manager;
+    QSet<QString> m_pending;
 };
 
-class ImageRequest : public QObject
+class ImageLoader : public QObject
 {
     Q_OBJECT
     
+public:
+    ~ImageLoader();
+    
+    static ImageLoader* instance();
+    
+    QImage* image(const QString &key) const;
+    
+    bool load(const QUrl &url, const ImageVariant &variant);
+    
 private:
-    ImageRequest(QNetworkAccessManager *manager, const QUrl &u);
-    ~ImageRequest();
+    ImageLoader();
     
-    QNetworkReply *reply;
-    QUrl url;
+    void startJob(const QUrl &url);
+    void startRequest(const ImageJob &job);
+    void nextRequest();
+    void insertImages(const ImageJob &job);
+    
+    static ImageLoader *self;
+    
+    QCache<QString, QImage> m_images;
+    QHash<QUrl, QList<ImageVariant> > m_pending;
+    QHash<QUrl, QList<ImageVariant> > m_variants;
+    QSet<QUrl> m_active;
+    QHash<QUrl, qint64> m_failed;
+    
+    QQueue<ImageJob> m_queue;
+    QHash<QNetworkReply*, ImageJob> m_requests;
+    
+    QNetworkAccessManager *m_manager;
     
-    friend class ImageCache;
+    QThreadPool *m_pool;
     
 private Q_SLOTS:
+    void onJobFinished(const ImageJob &job);
     void onReplyFinished();
     
 Q_SIGNALS:
-    void finished(ImageRequest *request);
+    void imagesLoaded(const QStringList &keys);
+};
+
+class ImageDecoder : public QRunnable
+{
+
+public:
+    enum Task {
+        Process = 0,
+        Touch
+    };
+    
+    ImageDecoder(ImageLoader *loader, const ImageJob &job, Task task = Process);
+    
+    void run();
+    
+private:
+    void process();
+    void touch();
+    
+    ImageLoader *m_loader;
+    ImageJob m_job;
+    Task m_task;
 };
     
 #endif // IMAGECACHE_H
@@ -16,6 +16,7 @@
 
 #include "clipboard.h"
 #include "database.h"
+#include "daemon.h"
 #include "dailymotion.h"
 #include "dbusservice.h"
 #include "mainwindow.h"
@@ -29,6 +30,10 @@
 #include <QSslConfiguration>
 
 int main(int argc, char *argv[]) {
+    if (isDaemonMode(argc, argv)) {
+        return execDaemon(argc, argv);
+    }
+    
     QApplication app(argc, argv);
     app.setOrganizationName("cuteTube2");
     app.setApplicationName("cuteTube2");
@@ -16,7 +16,7 @@
  */
 
 #include "pluginsettingscheckbox.h"
-#include <QSettings>
+#include "settings.h"
 
 PluginSettingsCheckbox::PluginSettingsCheckbox(QWidget *parent) :
     QCheckBox(parent)
@@ -33,12 +33,12 @@ void PluginSettingsCheckbox::setDefaultValue(const QVariant &value) {
 }
 
 void PluginSettingsCheckbox::load() {
-    bool enabled = QSettings().value(key(), defaultValue()).toBool();
+    bool enabled = Settings::instance()->value(key(), defaultValue()).toBool();
     setChecked(enabled);
 }
 
 void PluginSettingsCheckbox::onClicked(bool checked) {
     if (!key().isEmpty()) {
-        QSettings().setValue(key(), checked);
+        Settings::instance()->setValue(key(), checked);
     }
 }
@@ -16,7 +16,7 @@
  */
 
 #include "pluginsettingslineedit.h"
-#include <QSettings>
+#include "settings.h"
 
 PluginSettingsLineEdit::PluginSettingsLineEdit(QWidget *parent) :
     QLineEdit(parent)
@@ -33,12 +33,12 @@ void PluginSettingsLineEdit::setDefaultValue(const QVariant &value) {
 }
 
 void PluginSettingsLineEdit::load() {
-    QString text = QSettings().value(key(), defaultValue()).toString();
+    QString text = Settings::instance()->value(key(), defaultValue()).toString();
     setText(text);
 }
 
 void PluginSettingsLineEdit::onTextEdited(const QString &text) {
     if (!key().isEmpty()) {
-        QSettings().setValue(key(), text);
+        Settings::instance()->setValue(key(), text);
     }
 }
@@ -18,7 +18,7 @@
 #include "pluginsettingsselector.h"
 #include "selectionmodel.h"
 #include <QMaemo5ListPickSelector>
-#include <QSettings>
+#include "settings.h"
 
 PluginSettingsSelector::PluginSettingsSelector(const QString &text, QWidget *parent) :
     ValueSelector(text, parent)
@@ -39,7 +39,7 @@ void PluginSettingsSelector::load() {
         return;
     }
 
-    QVariant value = QSettings().value(key(), defaultValue());
+    QVariant value = Settings::instance()->value(key(), defaultValue());
 
     bool found = false;
     int i = 0;
@@ -61,6 +61,6 @@ void PluginSettingsSelector::load() {
 
 void PluginSettingsSelector::onSelected() {
     if (!key().isEmpty()) {
-        QSettings().setValue(key(), currentValue());
+        Settings::instance()->setValue(key(), currentValue());
     }
 }
@@ -16,7 +16,7 @@
  */
 
 #include "pluginsettingsslider.h"
-#include <QSettings>
+#include "settings.h"
 
 PluginSettingsSlider::PluginSettingsSlider(QWidget *parent) :
     QSlider(parent)
@@ -33,12 +33,12 @@ void PluginSettingsSlider::setDefaultValue(const QVariant &value) {
 }
 
 void PluginSettingsSlider::load() {
-    int value = QSettings().value(key(), defaultValue()).toInt();
+    int value = Settings::instance()->value(key(), defaultValue()).toInt();
     setValue(value);
 }
 
 void PluginSettingsSlider::onReleased() {
     if (!key().isEmpty()) {
-        QSettings().setValue(key(), value());
+        Settings::instance()->setValue(key(), value());
     }
 }
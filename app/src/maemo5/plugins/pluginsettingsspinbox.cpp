@@ -16,7 +16,7 @@
  */
 
 #include "pluginsettingsspinbox.h"
-#include <QSettings>
+#include "settings.h"
 
 PluginSettingsSpinbox::PluginSettingsSpinbox(QWidget *parent) :
     QSpinBox(parent)
@@ -33,12 +33,12 @@ void PluginSettingsSpinbox::setDefaultValue(const QVariant &value) {
 }
 
 void PluginSettingsSpinbox::load() {
-    int value = QSettings().value(key(), defaultValue()).toInt();
+    int value = Settings::instance()->value(key(), defaultValue()).toInt();
     setValue(value);
 }
 
 void PluginSettingsSpinbox::onValueEdited() {
     if (!key().isEmpty()) {
-        QSettings().setValue(key(), value());
+        Settings::instance()->setValue(key(), value());
     }
 }
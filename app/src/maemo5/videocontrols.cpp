@@ -19,6 +19,7 @@
 #include "imagecache.h"
 #include "resources.h"
 #include "settings.h"
+#include "streamcache.h"
 #include "utils.h"
 #include "videoplaybackdelegate.h"
 #include "videoplayerbutton.h"
@@ -201,6 +202,12 @@ void VideoControls::play(const CTVideo *video) {
     else {
         listStreams(Settings::instance()->defaultPlaybackFormat(video->service()).isEmpty());
     }
+    
+    if (const CTVideo *next = m_model->get(m_currentIndex + 1)) {
+        if (next->streamUrl().isEmpty()) {
+            StreamCache::instance()->prefetch(next->service(), next->id());
+        }
+    }
 }
 
 void VideoControls::play(const QUrl &url) {
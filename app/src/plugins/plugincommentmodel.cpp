@@ -18,19 +18,23 @@
 #include "resources.h"
 
 PluginCommentModel::PluginCommentModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[BodyRole] = "body";
-    m_roles[DateRole] = "date";
-    m_roles[IdRole] = "id";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoIdRole] = "videoId";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<PluginComment> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BodyRole, "body", &CTComment::body);
+        roles.insert(DateRole, "date", &CTComment::date);
+        roles.insert(IdRole, "id", &CTComment::id);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTComment::thumbnailUrl);
+        roles.insert(UserIdRole, "userId", &CTComment::userId);
+        roles.insert(UsernameRole, "username", &CTComment::username);
+        roles.insert(VideoIdRole, "videoId", &CTComment::videoId);
+    }
+    
+    setRoleTable(&roles);
+    
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -51,12 +55,6 @@ ResourcesRequest::Status PluginCommentModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> PluginCommentModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int PluginCommentModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -74,49 +72,6 @@ void PluginCommentModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant PluginCommentModel::data(const QModelIndex &index, int role) const {
-    if (PluginComment *comment = get(index.row())) {
-        return comment->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> PluginCommentModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (PluginComment *comment = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = comment->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant PluginCommentModel::data(int row, const QByteArray &role) const {
-    if (PluginComment *comment = get(row)) {
-        return comment->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap PluginCommentModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (PluginComment *comment = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = comment->property(role);
-        }
-    }
-    
-    return map;
-}
-
 PluginComment* PluginCommentModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
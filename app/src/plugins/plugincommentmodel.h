@@ -19,9 +19,9 @@
 
 #include "resourcesrequest.h"
 #include "plugincomment.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class PluginCommentModel : public QAbstractListModel
+class PluginCommentModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -51,20 +51,11 @@ public:
     
     ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE PluginComment* get(int row) const;
     
     Q_INVOKABLE void list(const QString &id);
@@ -97,8 +88,6 @@ private:
     QString m_next;
         
     QList<PluginComment*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINCOMMENTMODEL_H
@@ -18,22 +18,26 @@
 #include "resources.h"
 
 PluginPlaylistModel::PluginPlaylistModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ServiceRole] = "service";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoCountRole] = "videoCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<PluginPlaylist> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTPlaylist::date);
+        roles.insert(DescriptionRole, "description", &CTPlaylist::description);
+        roles.insert(IdRole, "id", &CTPlaylist::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTPlaylist::largeThumbnailUrl);
+        roles.insert(ServiceRole, "service", &CTPlaylist::service);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTPlaylist::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTPlaylist::title);
+        roles.insert(UserIdRole, "userId", &CTPlaylist::userId);
+        roles.insert(UsernameRole, "username", &CTPlaylist::username);
+        roles.insert(VideoCountRole, "videoCount", &CTPlaylist::videoCount);
+    }
+    
+    setRoleTable(&roles);
+    
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -54,12 +58,6 @@ ResourcesRequest::Status PluginPlaylistModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> PluginPlaylistModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int PluginPlaylistModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -77,49 +75,6 @@ void PluginPlaylistModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant PluginPlaylistModel::data(const QModelIndex &index, int role) const {
-    if (PluginPlaylist *playlist = get(index.row())) {
-        return playlist->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> PluginPlaylistModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (PluginPlaylist *playlist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = playlist->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant PluginPlaylistModel::data(int row, const QByteArray &role) const {
-    if (PluginPlaylist *playlist = get(row)) {
-        return playlist->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap PluginPlaylistModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (PluginPlaylist *playlist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = playlist->property(role);
-        }
-    }
-    
-    return map;
-}
-
 PluginPlaylist* PluginPlaylistModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
@@ -19,9 +19,9 @@
 
 #include "pluginplaylist.h"
 #include "resourcesrequest.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class PluginPlaylistModel : public QAbstractListModel
+class PluginPlaylistModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -54,20 +54,11 @@ public:
     
     ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE PluginPlaylist* get(int row) const;
     
     Q_INVOKABLE void list(const QString &id = QString());
@@ -100,8 +91,6 @@ private:
     QString m_next;
         
     QList<PluginPlaylist*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINPLAYLISTMODEL_H
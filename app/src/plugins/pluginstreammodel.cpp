@@ -16,10 +16,12 @@
 
 #include "pluginstreammodel.h"
 #include "resources.h"
+#include "streamcache.h"
 
 PluginStreamModel::PluginStreamModel(QObject *parent) :
     SelectionModel(parent),
-    m_request(new ResourcesRequest(this))
+    m_request(new ResourcesRequest(this)),
+    m_status(m_request->status())
 {
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
@@ -38,7 +40,7 @@ QString PluginStreamModel::errorString() const {
 }
 
 ResourcesRequest::Status PluginStreamModel::status() const {
-    return m_request->status();
+    return m_status;
 }
 
 void PluginStreamModel::list(const QString &id) {
@@ -48,34 +50,55 @@ void PluginStreamModel::list(const QString &id) {
     
     clear();
     m_id = id;
-    m_request->list(Resources::STREAM, id);
+    const QVariantList streams = StreamCache::instance()->streams(service(), id);
+    
+    if (!streams.isEmpty()) {
+        loadStreams(streams);
+        m_status = ResourcesRequest::Ready;
+    }
+    else {
+        m_request->list(Resources::STREAM, id);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
 }
 
 void PluginStreamModel::cancel() {
     m_request->cancel();
+    m_status = m_request->status();
 }
 
 void PluginStreamModel::reload() {
+    StreamCache::instance()->remove(service(), m_id);
     clear();
     m_request->list(Resources::STREAM, m_id);
+    m_status = m_request->status();
     emit statusChanged(status());
 }
 
-void PluginStreamModel::onRequestFinished() {
-    if (m_request->status() == ResourcesRequest::Ready) {
-        foreach (QVariant v, m_request->result().toMap().value("items").toList()) {
-            QVariantMap stream = v.toMap();
-            const int height = stream.value("height").toInt();
-            
-            if (height > 0) {
-                append(QString("%1p %2").arg(height).arg(stream.value("description").toString()), stream);
-            }
-            else {
-                append(tr("Unknown resolution %1").arg(stream.value("description").toString()), stream);
-            }
+void PluginStreamModel::loadStreams(const QVariantList &streams) {
+    foreach (QVariant v, streams) {
+        QVariantMap stream = v.toMap();
+        const int height = stream.value("height").toInt();
+        
+        if (height > 0) {
+            append(QString("%1p %2").arg(height).arg(stream.value("description").toString()), stream);
+        }
+        else {
+            append(tr("Unknown resolution %1").arg(stream.value("description").toString()), stream);
         }
     }
+}
+
+void PluginStreamModel::onRequestFinished() {
+    m_status = m_request->status();
+    
+    if (m_status == ResourcesRequest::Ready) {
+        const QVariantList streams = m_request->result().toMap().value("items").toList();
+        StreamCache::instance()->insert(service(), m_id, streams);
+        loadStreams(streams);
+    }
     
     emit statusChanged(status());
 }
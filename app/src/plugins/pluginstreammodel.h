@@ -44,6 +44,9 @@ public Q_SLOTS:
     void cancel();
     void reload();
 
+private:
+    void loadStreams(const QVariantList &streams);
+    
 private Q_SLOTS:
     void onRequestFinished();
     
@@ -53,6 +56,7 @@ Q_SIGNALS:
         
 private:
     ResourcesRequest *m_request;
+    ResourcesRequest::Status m_status;
     
     QString m_id;
 };
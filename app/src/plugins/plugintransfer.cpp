@@ -17,6 +17,7 @@
 #include "plugintransfer.h"
 #include "resources.h"
 #include "resourcesrequest.h"
+#include "streamcache.h"
 #ifdef CUTETUBE_DEBUG
 #include <QDebug>
 #endif
@@ -30,6 +31,13 @@ PluginTransfer::PluginTransfer(const QString &service, QObject *parent) :
 }
 
 void PluginTransfer::listStreams() {
+    const QVariantMap stream = selectStream(StreamCache::instance()->streams(service(), resourceId()));
+    
+    if (!stream.isEmpty()) {
+        startDownload(stream.value("url").toString());
+        return;
+    }
+    
     if (!m_streamsRequest) {
         m_streamsRequest = new ResourcesRequest(this);
         connect(m_streamsRequest, SIGNAL(finished()), this, SLOT(onStreamsRequestFinished()));
@@ -52,14 +60,12 @@ void PluginTransfer::listSubtitles() {
 void PluginTransfer::onStreamsRequestFinished() {
     if (m_streamsRequest->status() == ResourcesRequest::Ready) {
         QVariantList list = m_streamsRequest->result().toMap().value("items").toList();
+        StreamCache::instance()->insert(service(), resourceId(), list);
+        const QVariantMap stream = selectStream(list);
         
-        foreach (QVariant v, list) {
-            QVariantMap stream = v.toMap();
-        
-            if (stream.value("id") == streamId()) {
-                startDownload(stream.value("url").toString());
-                return;
-            }
+        if (!stream.isEmpty()) {
+            startDownload(stream.value("url").toString());
+            return;
         }
     }
     
@@ -83,10 +89,5 @@ void PluginTransfer::onSubtitlesRequestFinished() {
 #ifdef CUTETUBE_DEBUG
     qDebug() << "PluginTransfer::onSubtitlesRequestFinished: No subtitles found";
 #endif
-    if (convertToAudio()) {
-        startAudioConversion();
-    }
-    else {
-        moveDownloadedFiles();
-    }
+    finishSubtitlesDownload();
 }
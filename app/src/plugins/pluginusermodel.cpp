@@ -18,18 +18,22 @@
 #include "resources.h"
 
 PluginUserModel::PluginUserModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ServiceRole] = "service";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UsernameRole] = "username";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<PluginUser> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DescriptionRole, "description", &CTUser::description);
+        roles.insert(IdRole, "id", &CTUser::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTUser::largeThumbnailUrl);
+        roles.insert(ServiceRole, "service", &CTUser::service);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTUser::thumbnailUrl);
+        roles.insert(UsernameRole, "username", &CTUser::username);
+    }
+    
+    setRoleTable(&roles);
+    
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -50,12 +54,6 @@ ResourcesRequest::Status PluginUserModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> PluginUserModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int PluginUserModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -73,49 +71,6 @@ void PluginUserModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant PluginUserModel::data(const QModelIndex &index, int role) const {
-    if (PluginUser *user = get(index.row())) {
-        return user->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> PluginUserModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (PluginUser *user = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = user->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant PluginUserModel::data(int row, const QByteArray &role) const {
-    if (PluginUser *user = get(row)) {
-        return user->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap PluginUserModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (PluginUser *user = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = user->property(role);
-        }
-    }
-    
-    return map;
-}
-
 PluginUser* PluginUserModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
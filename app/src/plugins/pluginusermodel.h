@@ -19,9 +19,9 @@
 
 #include "resourcesrequest.h"
 #include "pluginuser.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class PluginUserModel : public QAbstractListModel
+class PluginUserModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -50,20 +50,11 @@ public:
     
     ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE PluginUser* get(int row) const;
     
     Q_INVOKABLE void list(const QString &id = QString());
@@ -96,8 +87,6 @@ private:
     QString m_next;
         
     QList<PluginUser*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINUSERMODEL_H
@@ -16,28 +16,44 @@
 
 #include "pluginvideomodel.h"
 #include "resources.h"
+#include "responsecache.h"
+#include "settings.h"
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
 
 PluginVideoModel::PluginVideoModel(QObject *parent) :
-    QAbstractListModel(parent),
-    m_request(new ResourcesRequest(this))
+    RoleListModel(parent),
+    m_request(new ResourcesRequest(this)),
+    m_prefetchRequest(0),
+    m_status(m_request->status()),
+    m_revalidating(false),
+    m_prefetchReady(false),
+    m_prefetchWaiting(false),
+    m_prefetchFailed(false),
+    m_prefetchQueued(false)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DownloadableRole] = "downloadable";
-    m_roles[DurationRole] = "duration";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ServiceRole] = "service";
-    m_roles[StreamUrlRole] = "streamUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[ViewCountRole] = "viewCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<PluginVideo> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTVideo::date);
+        roles.insert(DescriptionRole, "description", &CTVideo::description);
+        roles.insert(DownloadableRole, "downloadable", &CTVideo::isDownloadable);
+        roles.insert(DurationRole, "duration", &CTVideo::duration);
+        roles.insert(IdRole, "id", &CTVideo::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTVideo::largeThumbnailUrl);
+        roles.insert(ServiceRole, "service", &CTVideo::service);
+        roles.insert(StreamUrlRole, "streamUrl", &CTVideo::streamUrl);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTVideo::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTVideo::title);
+        roles.insert(UrlRole, "url", &CTVideo::url);
+        roles.insert(UserIdRole, "userId", &CTVideo::userId);
+        roles.insert(UsernameRole, "username", &CTVideo::username);
+        roles.insert(ViewCountRole, "viewCount", &CTVideo::viewCount);
+    }
+    
+    setRoleTable(&roles);
+    
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -55,14 +71,12 @@ QString PluginVideoModel::errorString() const {
 }
 
 ResourcesRequest::Status PluginVideoModel::status() const {
-    return m_request->status();
-}
-
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> PluginVideoModel::roleNames() const {
-    return m_roles;
+    if ((m_prefetchWaiting) && (isPrefetching())) {
+        return ResourcesRequest::Loading;
+    }
+    
+    return m_status;
 }
-#endif
 
 int PluginVideoModel::rowCount(const QModelIndex &) const {
     return m_items.size();
@@ -77,51 +91,30 @@ void PluginVideoModel::fetchMore(const QModelIndex &) {
         return;
     }
     
-    m_request->list(Resources::VIDEO, m_next);
-    emit statusChanged(status());
-}
-
-QVariant PluginVideoModel::data(const QModelIndex &index, int role) const {
-    if (PluginVideo *video = get(index.row())) {
-        return video->property(m_roles[role]);
-    }
+    m_prefetchFailed = false;
     
-    return QVariant();
-}
-
-QMap<int, QVariant> PluginVideoModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (PluginVideo *video = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = video->property(iterator.value());
-        }
+    if (m_prefetchReady) {
+        loadPrefetchedResults();
+        return;
     }
     
-    return map;
-}
-
-QVariant PluginVideoModel::data(int row, const QByteArray &role) const {
-    if (PluginVideo *video = get(row)) {
-        return video->property(role);
+    if (isPrefetching()) {
+        m_prefetchWaiting = true;
+        emit statusChanged(status());
+        return;
     }
     
-    return QVariant();
+    m_request->list(Resources::VIDEO, m_next);
+    m_status = m_request->status();
+    emit statusChanged(status());
 }
 
-QVariantMap PluginVideoModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (PluginVideo *video = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = video->property(role);
-        }
+QVariant PluginVideoModel::data(const QModelIndex &index, int role) const {
+    if (get(index.row())) {
+        prefetchIfNeeded(index.row());
     }
     
-    return map;
+    return RoleListModel::data(index, role);
 }
 
 PluginVideo* PluginVideoModel::get(int row) const {
@@ -140,7 +133,15 @@ void PluginVideoModel::list(const QString &id) {
     clear();
     m_id = id;
     m_query = QString();
-    m_request->list(Resources::VIDEO, id);
+    
+    if (loadCachedResult()) {
+        m_status = ResourcesRequest::Ready;
+    }
+    else {
+        m_request->list(Resources::VIDEO, id);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
 }
 
@@ -153,11 +154,22 @@ void PluginVideoModel::search(const QString &query, const QString &order) {
     m_id = QString();
     m_query = query;
     m_order = order;
-    m_request->search(Resources::VIDEO, query, order);
+    
+    if (loadCachedResult()) {
+        m_status = ResourcesRequest::Ready;
+    }
+    else {
+        m_request->search(Resources::VIDEO, query, order);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
 }
 
 void PluginVideoModel::clear() {
+    cancelPrefetch();
+    m_prefetchFailed = false;
+    
     if (!m_items.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
@@ -169,11 +181,13 @@ void PluginVideoModel::clear() {
 }
 
 void PluginVideoModel::cancel() {
+    cancelPrefetch();
     m_request->cancel();
 }
 
 void PluginVideoModel::reload() {
     clear();
+    m_cacheKey = cacheKey();
     
     if (m_query.isEmpty()) {
         m_request->list(Resources::VIDEO, m_id);
@@ -182,9 +196,143 @@ void PluginVideoModel::reload() {
         m_request->search(Resources::VIDEO, m_query, m_order);
     }
     
+    m_status = m_request->status();
+    emit statusChanged(status());
+}
+
+QVariantMap PluginVideoModel::cacheFilters() const {
+    QVariantMap filters;
+    
+    if (m_query.isEmpty()) {
+        filters["id"] = m_id;
+    }
+    else {
+        filters["query"] = m_query;
+        filters["order"] = m_order;
+    }
+    
+    return filters;
+}
+
+QString PluginVideoModel::cacheKey() const {
+    return ResponseCache::cacheKey(service(), Resources::VIDEO, cacheFilters());
+}
+
+bool PluginVideoModel::loadCachedResult() {
+    bool stale = false;
+    m_cacheKey = cacheKey();
+    const QVariantMap result = ResponseCache::instance()->result(m_cacheKey, &stale).toMap();
+    
+    if (result.isEmpty()) {
+        return false;
+    }
+    
+    loadResult(result);
+    
+    if (stale) {
+        m_revalidating = true;
+        return false;
+    }
+    
+    m_cacheKey = QString();
+    return true;
+}
+
+void PluginVideoModel::loadResult(const QVariantMap &result) {
+    m_next = result.value("next").toString();
+    const QVariantList list = result.value("items").toList();
+    
+    if (!list.isEmpty()) {
+        loadResults(list);
+    }
+}
+
+void PluginVideoModel::loadResults(const QVariantList &list) {
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
+    
+    foreach (QVariant item, list) {
+        m_items << new PluginVideo(service(), item.toMap(), this);
+    }
+
+    endInsertRows();
+    emit countChanged(rowCount());
+}
+
+bool PluginVideoModel::isPrefetching() const {
+    return (m_prefetchRequest) && (m_prefetchRequest->status() == ResourcesRequest::Loading);
+}
+
+void PluginVideoModel::prefetchIfNeeded(int row) const {
+    if ((m_prefetchReady) || (m_prefetchFailed) || (m_prefetchQueued) || (m_next.isEmpty()) || (isPrefetching())) {
+        return;
+    }
+    
+    const int threshold = Settings::instance()->prefetchThreshold();
+    
+    if ((threshold > 0) && (row >= m_items.size() - threshold)) {
+        m_prefetchQueued = true;
+        QMetaObject::invokeMethod(const_cast<PluginVideoModel*>(this), "prefetch", Qt::QueuedConnection);
+    }
+}
+
+void PluginVideoModel::prefetch() {
+    m_prefetchQueued = false;
+    
+    if ((m_prefetchReady) || (m_next.isEmpty()) || (isPrefetching()) || (status() == ResourcesRequest::Loading)) {
+        return;
+    }
+    
+    if (!m_prefetchRequest) {
+        m_prefetchRequest = new ResourcesRequest(this);
+        connect(m_prefetchRequest, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+    }
+    
+    m_prefetchRequest->setService(service());
+    m_prefetchRequest->list(Resources::VIDEO, m_next);
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "PluginVideoModel::prefetch" << service() << m_next;
+#endif
+}
+
+void PluginVideoModel::cancelPrefetch() {
+    m_prefetchWaiting = false;
+    m_prefetchReady = false;
+    m_prefetchResults.clear();
+    m_prefetchNext = QString();
+    
+    if (m_prefetchRequest) {
+        m_prefetchRequest->cancel();
+    }
+}
+
+void PluginVideoModel::loadPrefetchedResults() {
+    const QVariantList list = m_prefetchResults;
+    m_next = m_prefetchNext;
+    m_prefetchResults.clear();
+    m_prefetchNext = QString();
+    m_prefetchReady = false;
+    m_prefetchWaiting = false;
+    
+    if (!list.isEmpty()) {
+        loadResults(list);
+    }
+    
     emit statusChanged(status());
 }
 
+void PluginVideoModel::finishPrefetch() {
+    if (m_prefetchWaiting) {
+        m_prefetchWaiting = false;
+        
+        if (m_prefetchReady) {
+            loadPrefetchedResults();
+        }
+        else {
+            fetchMore();
+        }
+    }
+}
+
 void PluginVideoModel::append(PluginVideo *video) {
     beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
     m_items << video;
@@ -215,20 +363,42 @@ void PluginVideoModel::onRequestFinished() {
         QVariantMap result = m_request->result().toMap();
         
         if (!result.isEmpty()) {
-            m_next = result.value("next").toString();
-            QVariantList list = result.value("items").toList();
-
-            beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
-    
-            foreach (QVariant item, list) {
-                m_items << new PluginVideo(service(), item.toMap(), this);
+            const bool changed = (!m_revalidating) || (result != ResponseCache::instance()->result(m_cacheKey).toMap());
+            
+            if (!m_cacheKey.isEmpty()) {
+                ResponseCache::instance()->insert(m_cacheKey, result,
+                                                  ResponseCache::timeToLive(Resources::VIDEO, cacheFilters()));
             }
-
-            endInsertRows();
-            emit countChanged(rowCount());
+            
+            if (changed) {
+                if (m_revalidating) {
+                    clear();
+                }
                 
+                loadResult(result);
+            }
         }
     }
     
+    // A failed revalidation keeps showing the cached page
+    m_status = m_revalidating ? ResourcesRequest::Ready : m_request->status();
+    m_cacheKey = QString();
+    m_revalidating = false;
     emit statusChanged(status());
 }
+
+void PluginVideoModel::onPrefetchRequestFinished() {
+    m_prefetchFailed = (m_prefetchRequest->status() == ResourcesRequest::Failed);
+    
+    if (m_prefetchRequest->status() == ResourcesRequest::Ready) {
+        QVariantMap result = m_prefetchRequest->result().toMap();
+        
+        if (!result.isEmpty()) {
+            m_prefetchNext = result.value("next").toString();
+            m_prefetchResults = result.value("items").toList();
+            m_prefetchReady = true;
+        }
+    }
+    
+    finishPrefetch();
+}
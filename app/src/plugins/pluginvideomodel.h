@@ -19,9 +19,9 @@
 
 #include "resourcesrequest.h"
 #include "pluginvideo.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class PluginVideoModel : public QAbstractListModel
+class PluginVideoModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -58,19 +58,13 @@ public:
     
     ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
+    using RoleListModel::data;
     QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
     
     Q_INVOKABLE PluginVideo* get(int row) const;
     
@@ -82,13 +76,27 @@ public Q_SLOTS:
     void cancel();
     void reload();
     
-private:    
+private:
+    QVariantMap cacheFilters() const;
+    QString cacheKey() const;
+    bool loadCachedResult();
+    void loadResult(const QVariantMap &result);
+    void loadResults(const QVariantList &list);
+    
+    bool isPrefetching() const;
+    void prefetchIfNeeded(int row) const;
+    void cancelPrefetch();
+    void loadPrefetchedResults();
+    void finishPrefetch();
+    
     void append(PluginVideo *video);
     void insert(int row, PluginVideo *video);
     void remove(int row);
     
 private Q_SLOTS:
     void onRequestFinished();
+    void prefetch();
+    void onPrefetchRequestFinished();
     
 Q_SIGNALS:
     void countChanged(int c);
@@ -97,15 +105,26 @@ Q_SIGNALS:
     
 private:
     ResourcesRequest *m_request;
+    ResourcesRequest *m_prefetchRequest;
+    
+    ResourcesRequest::Status m_status;
     
     QString m_id;
     QString m_query;
     QString m_order;
     QString m_next;
+    
+    QString m_cacheKey;
+    bool m_revalidating;
+    
+    QVariantList m_prefetchResults;
+    QString m_prefetchNext;
+    bool m_prefetchReady;
+    bool m_prefetchWaiting;
+    bool m_prefetchFailed;
+    mutable bool m_prefetchQueued;
         
     QList<PluginVideo*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINVIDEOMODEL_H
@@ -16,6 +16,7 @@
 
 #include "resourcesplugins.h"
 #include "definitions.h"
+#include "resourcesworker.h"
 #include <QDomDocument>
 #include <QDomElement>
 #include <QFile>
@@ -73,7 +74,57 @@ bool ResourcesPlugins::resourceTypeIsSupported(const QString &pluginName, const
     return false;
 }
 
+ResourcesWorker* ResourcesPlugins::getWorkerForPlugin(const QString &name) {
+    if (ResourcesWorker *worker = m_workers.value(name)) {
+        m_recentWorkers.removeOne(name);
+        m_recentWorkers.append(name);
+        return worker;
+    }
+    
+    const ResourcesPlugin plugin = getPluginFromName(name);
+    
+    if ((!plugin.worker) || (plugin.command.isEmpty())) {
+        return 0;
+    }
+    
+    if (m_workers.size() >= MAX_PLUGIN_WORKERS) {
+        foreach (const QString &recent, m_recentWorkers) {
+            ResourcesWorker *worker = m_workers.value(recent);
+            
+            if (!worker->isBusy()) {
+#ifdef CUTETUBE_DEBUG
+                qDebug() << "ResourcesPlugins::getWorkerForPlugin: Removing idle worker" << recent;
+#endif
+                m_workers.remove(recent);
+                m_recentWorkers.removeOne(recent);
+                worker->stop();
+                worker->deleteLater();
+                break;
+            }
+        }
+        
+        if (m_workers.size() >= MAX_PLUGIN_WORKERS) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "ResourcesPlugins::getWorkerForPlugin: No worker available for" << name;
+#endif
+            return 0;
+        }
+    }
+    
+    ResourcesWorker *worker = new ResourcesWorker(plugin.command, plugin.workerTimeout, this);
+    m_workers[name] = worker;
+    m_recentWorkers.append(name);
+    return worker;
+}
+
 void ResourcesPlugins::load() {
+    foreach (ResourcesWorker *worker, m_workers) {
+        worker->stop();
+        worker->deleteLater();
+    }
+    
+    m_workers.clear();
+    m_recentWorkers.clear();
     m_plugins.clear();
     QDir dir;
 
@@ -112,6 +163,12 @@ void ResourcesPlugins::load() {
                 plugin.name = name;
                 plugin.command = command;
                 
+                if (docElem.attribute("worker") == "true") {
+                    plugin.worker = true;
+                    const int timeout = docElem.attribute("workerTimeout").toInt();
+                    plugin.workerTimeout = timeout > 0 ? timeout * 1000 : PLUGIN_WORKER_TIMEOUT;
+                }
+                
                 if (docElem.hasAttribute("settings")) {
                     QString settings = docElem.attribute("settings");
                     plugin.settings = settings.startsWith('/') ? settings : path + settings;
@@ -19,14 +19,25 @@
 
 #include "resources.h"
 #include <QObject>
+#include <QHash>
 #include <QMap>
 #include <QStringList>
 #include <QRegExp>
 
+class ResourcesWorker;
+
 struct ResourcesPlugin {
+    ResourcesPlugin() :
+        worker(false),
+        workerTimeout(0)
+    {
+    }
+    
     QString name;
     QString command;
     QString settings;
+    bool worker;
+    int workerTimeout;
     QMultiMap<QString, ListResource> listResources;
     QMultiMap<QString, SearchResource> searchResources;
     QMap<QString, QRegExp> regExps;
@@ -51,6 +62,8 @@ public:
     Q_INVOKABLE bool resourceTypeIsSupported(const QString &pluginName, const QString &resourceType,
                                              const QString &method = QString("list")) const;
     
+    ResourcesWorker* getWorkerForPlugin(const QString &name);
+    
 public Q_SLOTS:
     void load();
     
@@ -58,6 +71,9 @@ private:
     static ResourcesPlugins *self;
     
     QMap<QString, ResourcesPlugin> m_plugins;
+    
+    QHash<QString, ResourcesWorker*> m_workers;
+    QStringList m_recentWorkers;
 };
 
 #endif // RESOURCESPLUGINS_H
@@ -15,8 +15,9 @@
  */
 
 #include "resourcesrequest.h"
-#include "json.h"
 #include "resourcesplugins.h"
+#include "resourcesworker.h"
+#include "settings.h"
 #include <QProcess>
 #ifdef CUTETUBE_DEBUG
 #include <QDebug>
@@ -25,9 +26,11 @@
 ResourcesRequest::ResourcesRequest(QObject *parent) :
     QObject(parent),
     m_process(new QProcess(this)),
+    m_requestId(0),
     m_status(Null),
     m_error(NoError)
 {
+    connect(m_process, SIGNAL(readyReadStandardOutput()), this, SLOT(onProcessReadyRead()));
     connect(m_process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onProcessFinished(int)));
     connect(m_process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(onProcessError()));
 }
@@ -98,43 +101,28 @@ void ResourcesRequest::list(const QString &resourceType, const QString &id) {
         return;
     }
     
-    ResourcesPlugin plugin = ResourcesPlugins::instance()->getPluginFromName(service());
-    
-    if (plugin.command.isEmpty()) {
-        setStatus(Failed);
-        setError(PluginError);
-        setErrorString(tr("No plugin found for %1").arg(service()));
-        emit finished();
-        return;
-    }
-    
-    setStatus(Loading);
-    QStringList args = QStringList() << "-m" << "list" << "-r" << resourceType;
+    QVariantMap request;
+    request["method"] = "list";
+    request["resource"] = resourceType;
     
     if (!id.isEmpty()) {
-        args << "-i" << id;
+        request["id"] = id;
     }
     
-    start(plugin.command, args);
+    start(request);
 }
 
 void ResourcesRequest::search(const QString &resourceType, const QString &query, const QString &order) {
     if (status() == Loading) {
         return;
     }
-        
-    ResourcesPlugin plugin = ResourcesPlugins::instance()->getPluginFromName(service());
-    
-    if (plugin.command.isEmpty()) {
-        setStatus(Failed);
-        setError(PluginError);
-        setErrorString(tr("No plugin found for %1").arg(service()));
-        emit finished();
-        return;
-    }
     
-    setStatus(Loading);
-    start(plugin.command, QStringList() << "-m" << "search" << "-r" << resourceType << "-q" << query << "-o" << order);
+    QVariantMap request;
+    request["method"] = "search";
+    request["resource"] = resourceType;
+    request["query"] = query;
+    request["order"] = order;
+    start(request);
 }
 
 void ResourcesRequest::get(const QString &resourceType, const QString &id) {
@@ -142,6 +130,14 @@ void ResourcesRequest::get(const QString &resourceType, const QString &id) {
         return;
     }
     
+    QVariantMap request;
+    request["method"] = "get";
+    request["resource"] = resourceType;
+    request["id"] = id;
+    start(request);
+}
+
+void ResourcesRequest::start(const QVariantMap &request) {
     ResourcesPlugin plugin = ResourcesPlugins::instance()->getPluginFromName(service());
     
     if (plugin.command.isEmpty()) {
@@ -153,23 +149,75 @@ void ResourcesRequest::get(const QString &resourceType, const QString &id) {
     }
     
     setStatus(Loading);
-    start(plugin.command, QStringList() << "-m" << "get" << "-r" << resourceType << "-i" << id);
-}
-
-void ResourcesRequest::start(const QString &program, const QStringList &args) {
+    // Plugins read their settings from disk, so write any pending changes first
+    Settings::instance()->flush();
+    
+    if (plugin.worker) {
+        m_worker = ResourcesPlugins::instance()->getWorkerForPlugin(service());
+        
+        if (m_worker) {
+            connect(m_worker, SIGNAL(requestFinished(int, QVariant)),
+                    this, SLOT(onWorkerRequestFinished(int, QVariant)));
+            connect(m_worker, SIGNAL(requestFailed(int, QString, bool)),
+                    this, SLOT(onWorkerRequestFailed(int, QString, bool)));
+            m_requestId = m_worker->request(request);
+            return;
+        }
+    }
+    
+    QStringList args = QStringList() << "-m" << request.value("method").toString()
+                                     << "-r" << request.value("resource").toString();
+    
+    if (request.contains("id")) {
+        args << "-i" << request.value("id").toString();
+    }
+    
+    if (request.contains("query")) {
+        args << "-q" << request.value("query").toString();
+    }
+    
+    if (request.contains("order")) {
+        args << "-o" << request.value("order").toString();
+    }
 #ifdef CUTETUBE_DEBUG
-    qDebug() << "ResourcesRequest::start" << program << args;
+    qDebug() << "ResourcesRequest::start" << plugin.command << args;
 #endif
-    m_process->start(program, args);
+    m_parser.clear();
+    m_process->start(plugin.command, args);
+}
+
+void ResourcesRequest::disconnectWorker() {
+    if (m_worker) {
+        disconnect(m_worker, 0, this, 0);
+        m_worker = 0;
+    }
+    
+    m_requestId = 0;
 }
 
 void ResourcesRequest::cancel() {
-    m_process->kill();
+    if (m_requestId) {
+        m_worker->cancel(m_requestId);
+        disconnectWorker();
+        setStatus(Canceled);
+        setError(NoError);
+        setErrorString(QString());
+        emit finished();
+    }
+    else {
+        m_process->kill();
+    }
+}
+
+void ResourcesRequest::onProcessReadyRead() {
+    m_parser.feed(m_process->readAllStandardOutput());
 }
 
 void ResourcesRequest::onProcessFinished(int exitCode) {
-    bool ok;
-    setResult(QtJson::Json::parse(QString::fromUtf8(m_process->readAllStandardOutput()), ok));
+    m_parser.feed(m_process->readAllStandardOutput());
+    const bool ok = m_parser.finish();
+    setResult(m_parser.result());
+    m_parser.clear();
         
     if (exitCode == 0) {
         if (ok) {
@@ -211,3 +259,29 @@ void ResourcesRequest::onProcessError() {
     setErrorString(m_process->errorString());
     emit finished();
 }
+
+void ResourcesRequest::onWorkerRequestFinished(int requestId, const QVariant &result) {
+    if (requestId != m_requestId) {
+        return;
+    }
+    
+    disconnectWorker();
+    setResult(result);
+    setStatus(Ready);
+    setError(NoError);
+    setErrorString(QString());
+    emit finished();
+}
+
+void ResourcesRequest::onWorkerRequestFailed(int requestId, const QString &errorString, bool parseError) {
+    if (requestId != m_requestId) {
+        return;
+    }
+    
+    disconnectWorker();
+    setResult(QVariant());
+    setStatus(Failed);
+    setError(parseError ? ParseError : ProcessError);
+    setErrorString(errorString);
+    emit finished();
+}
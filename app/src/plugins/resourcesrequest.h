@@ -17,10 +17,13 @@
 #ifndef RESOURCESREQUEST_H
 #define RESOURCESREQUEST_H
 
+#include "jsonparser.h"
 #include <QObject>
+#include <QPointer>
 #include <QString>
 #include <QVariant>
 
+class ResourcesWorker;
 class QProcess;
 
 class ResourcesRequest : public QObject
@@ -74,7 +77,9 @@ public Q_SLOTS:
     void cancel();
     
 private:
-    void start(const QString &program, const QStringList &args);
+    void start(const QVariantMap &request);
+    
+    void disconnectWorker();
     
     void setStatus(Status s);
     
@@ -85,9 +90,13 @@ private:
     void setErrorString(const QString &es);
     
 private Q_SLOTS:
+    void onProcessReadyRead();
     void onProcessFinished(int exitCode);
     void onProcessError();
     
+    void onWorkerRequestFinished(int requestId, const QVariant &result);
+    void onWorkerRequestFailed(int requestId, const QString &errorString, bool parseError);
+    
 Q_SIGNALS:
     void serviceChanged();
     void statusChanged(Status s);
@@ -95,6 +104,11 @@ Q_SIGNALS:
     
 private:
     QProcess *m_process;
+    
+    JsonParser m_parser;
+    
+    QPointer<ResourcesWorker> m_worker;
+    int m_requestId;
         
     QString m_service;
     
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resourcesworker.h"
+#include "json.h"
+#include "jsonparser.h"
+#ifdef CUTETUBE_DEBUG
+#include <QDebug>
+#endif
+
+int ResourcesWorker::requestCount = 0;
+
+ResourcesWorker::ResourcesWorker(const QString &command, int idleTimeout, QObject *parent) :
+    QObject(parent),
+    m_command(command),
+    m_stopping(false),
+    m_current(0)
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(idleTimeout);
+    
+    connect(&m_idleTimer, SIGNAL(timeout()), this, SLOT(stop()));
+    connect(&m_process, SIGNAL(readyReadStandardOutput()), this, SLOT(onReadyRead()));
+    connect(&m_process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onProcessFinished()));
+    connect(&m_process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(onProcessError()));
+}
+
+ResourcesWorker::~ResourcesWorker() {
+    m_process.disconnect(this);
+    failAll(tr("Plugin worker stopped"));
+}
+
+QString ResourcesWorker::command() const {
+    return m_command;
+}
+
+bool ResourcesWorker::isBusy() const {
+    return (!m_pending.isEmpty()) || (m_current != 0);
+}
+
+int ResourcesWorker::request(const QVariantMap &request) {
+    m_idleTimer.stop();
+    const int id = ++requestCount;
+    QVariantMap map = request;
+    map["requestId"] = id;
+    m_queue.enqueue(map);
+    m_pending << id;
+    
+    if ((m_current) && (!m_pending.contains(m_current))) {
+        // The worker is still busy with a canceled request, so don't make this one wait for it
+        restart();
+    }
+    else {
+        next();
+    }
+    
+    return id;
+}
+
+void ResourcesWorker::cancel(int requestId) {
+    if (!m_pending.removeOne(requestId)) {
+        return;
+    }
+    
+    for (int i = 0; i < m_queue.size(); i++) {
+        if (m_queue.at(i).value("requestId").toInt() == requestId) {
+            m_queue.removeAt(i);
+            return;
+        }
+    }
+    
+    if ((requestId == m_current) && (!m_queue.isEmpty())) {
+        restart();
+    }
+}
+
+void ResourcesWorker::next() {
+    if ((m_current) || (m_stopping) || (m_queue.isEmpty())) {
+        return;
+    }
+    
+    if (m_process.state() == QProcess::NotRunning) {
+        m_buffer.clear();
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "ResourcesWorker::next: Starting worker" << command();
+#endif
+        m_process.start(command(), QStringList() << "-w");
+    }
+    
+    const QVariantMap map = m_queue.dequeue();
+    m_current = map.value("requestId").toInt();
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "ResourcesWorker::next" << command() << map;
+#endif
+    m_process.write(QtJson::Json::serialize(map) + "\n");
+}
+
+void ResourcesWorker::restart() {
+    if ((m_stopping) || (m_process.state() == QProcess::NotRunning)) {
+        return;
+    }
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "ResourcesWorker::restart: Restarting worker" << command();
+#endif
+    // onProcessFinished() starts the next request
+    m_stopping = true;
+    m_process.kill();
+}
+
+void ResourcesWorker::stop() {
+    m_idleTimer.stop();
+    
+    if (m_process.state() != QProcess::NotRunning) {
+#ifdef CUTETUBE_DEBUG
+        qDebug() << "ResourcesWorker::stop: Stopping worker" << command();
+#endif
+        m_stopping = true;
+        m_process.closeWriteChannel();
+    }
+}
+
+void ResourcesWorker::failAll(const QString &errorString) {
+    m_queue.clear();
+    m_current = 0;
+    
+    while (!m_pending.isEmpty()) {
+        emit requestFailed(m_pending.takeFirst(), errorString, false);
+    }
+}
+
+void ResourcesWorker::onReadyRead() {
+    m_buffer += m_process.readAllStandardOutput();
+    int end = m_buffer.indexOf('\n');
+    
+    while (end != -1) {
+        const QByteArray line = m_buffer.left(end).trimmed();
+        m_buffer.remove(0, end + 1);
+        end = m_buffer.indexOf('\n');
+        
+        if (line.isEmpty()) {
+            continue;
+        }
+        
+        bool ok;
+        const QVariantMap response = JsonParser::parse(line, ok).toMap();
+        const int id = response.value("requestId").toInt();
+        
+        if ((!ok) || (!id)) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "ResourcesWorker::onReadyRead: Ignoring unexpected output" << line;
+#endif
+            continue;
+        }
+        
+        if (id == m_current) {
+            m_current = 0;
+        }
+        
+        if (!m_pending.removeOne(id)) {
+#ifdef CUTETUBE_DEBUG
+            qDebug() << "ResourcesWorker::onReadyRead: Dropping response to canceled request" << id;
+#endif
+            continue;
+        }
+        
+        if (response.contains("error")) {
+            emit requestFailed(id, response.value("error").toString(), false);
+        }
+        else {
+            emit requestFinished(id, response.value("result"));
+        }
+    }
+    
+    next();
+    
+    if (!isBusy()) {
+        m_idleTimer.start();
+    }
+}
+
+void ResourcesWorker::onProcessFinished() {
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "ResourcesWorker::onProcessFinished" << command();
+#endif
+    m_idleTimer.stop();
+    m_stopping = false;
+    m_buffer.clear();
+    
+    if (m_current) {
+        const int id = m_current;
+        m_current = 0;
+        
+        if (m_pending.removeOne(id)) {
+            emit requestFailed(id, tr("Plugin worker exited unexpectedly"), false);
+        }
+    }
+    
+    next();
+}
+
+void ResourcesWorker::onProcessError() {
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "ResourcesWorker::onProcessError" << command() << m_process.errorString();
+#endif
+    // Other errors are followed by finished()
+    if (m_process.error() == QProcess::FailedToStart) {
+        m_idleTimer.stop();
+        m_stopping = false;
+        failAll(m_process.errorString());
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCESWORKER_H
+#define RESOURCESWORKER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QTimer>
+#include <QVariantMap>
+
+class ResourcesWorker : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit ResourcesWorker(const QString &command, int idleTimeout, QObject *parent = 0);
+    ~ResourcesWorker();
+    
+    QString command() const;
+    
+    bool isBusy() const;
+    
+    int request(const QVariantMap &request);
+    void cancel(int requestId);
+    
+public Q_SLOTS:
+    void stop();
+    
+private Q_SLOTS:
+    void onReadyRead();
+    void onProcessFinished();
+    void onProcessError();
+    
+Q_SIGNALS:
+    void requestFinished(int requestId, const QVariant &result);
+    void requestFailed(int requestId, const QString &errorString, bool parseError);
+    
+private:
+    void next();
+    void restart();
+    
+    void failAll(const QString &errorString);
+    
+    static int requestCount;
+    
+    QProcess m_process;
+    
+    QTimer m_idleTimer;
+    
+    QString m_command;
+    
+    bool m_stopping;
+    
+    QByteArray m_buffer;
+    
+    QQueue<QVariantMap> m_queue;
+    QList<int> m_pending;
+    
+    int m_current;
+};
+
+#endif // RESOURCESWORKER_H
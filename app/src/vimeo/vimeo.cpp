@@ -16,9 +16,8 @@
 
 #include "vimeo.h"
 #include "database.h"
+#include "settings.h"
 #include <qvimeo/urls.h>
-#include <QSettings>
-#include <QSqlRecord>
 #if QT_VERSION >= 0x050000
 #include <QUrlQuery>
 #endif
@@ -36,6 +35,7 @@ static const QStringList SCOPES = QStringList() << QVimeo::PUBLIC_SCOPE << QVime
 
 const QRegExp Vimeo::URL_REGEXP("http(s|)://vimeo.com/\\w+", Qt::CaseInsensitive);
 
+Vimeo::AccountCache Vimeo::accountCache;
 Vimeo::SubscriptionCache Vimeo::subscriptionCache;
 
 Vimeo* Vimeo::self = 0;
@@ -58,6 +58,31 @@ Vimeo* Vimeo::instance() {
     return self;
 }
 
+void Vimeo::reloadAccounts() {
+    accountCache.accounts.clear();
+    accountCache.loaded = false;
+}
+
+Vimeo::Account Vimeo::account(const QString &userId) {
+    if (!accountCache.loaded) {
+        accountCache.loaded = true;
+        QSqlQuery query = getDatabase().exec("SELECT userId, accessToken, scopes FROM vimeoAccounts");
+        
+        if (query.lastError().isValid()) {
+            qDebug() << "Vimeo::account: database error:" << query.lastError().text();
+        }
+        
+        while (query.next()) {
+            Account account;
+            account.accessToken = query.value(1).toString();
+            account.scopes = query.value(2).toString();
+            accountCache.accounts[query.value(0).toString()] = account;
+        }
+    }
+    
+    return accountCache.accounts.value(userId);
+}
+
 QString Vimeo::getErrorString(const QVariantMap &error) {
     return error.contains("error") ? error.value("error").toString() : tr("Unknown error");
 }
@@ -92,12 +117,12 @@ QUrl Vimeo::authUrl() const {
 }
 
 QString Vimeo::userId() const {
-    return QSettings().value("Vimeo/userId").toString();
+    return Settings::instance()->value("Vimeo/userId").toString();
 }
 
 void Vimeo::setUserId(const QString &id) {
     if (id != userId()) {
-        QSettings().setValue("Vimeo/userId", id);
+        Settings::instance()->setValue("Vimeo/userId", id);
         subscriptionCache.ids.clear();
         subscriptionCache.filters.clear();
         subscriptionCache.hasMore = true;
@@ -110,29 +135,25 @@ QString Vimeo::accessToken() const {
         return CLIENT_TOKEN;
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT accessToken FROM vimeoAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "Vimeo::accessToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    return account(userId()).accessToken;
 }
 
 void Vimeo::setAccessToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE vimeoAccounts SET accessToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE vimeoAccounts SET accessToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "Vimeo::setAccessToken: database error:" << query.lastError().text();
     }
     else {
+        QHash<QString, Account>::iterator iterator = accountCache.accounts.find(userId());
+        
+        if (iterator != accountCache.accounts.end()) {
+            iterator.value().accessToken = token;
+        }
+        
         emit accessTokenChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -141,12 +162,12 @@ void Vimeo::setAccessToken(const QString &token) {
 }
 
 QString Vimeo::clientId() const {
-    return QSettings().value("Vimeo/clientId", CLIENT_ID).toString();
+    return Settings::instance()->value("Vimeo/clientId", CLIENT_ID).toString();
 }
 
 void Vimeo::setClientId(const QString &id) {
     if (id != clientId()) {
-        QSettings().setValue("Vimeo/clientId", id);
+        Settings::instance()->setValue("Vimeo/clientId", id);
         emit clientIdChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -155,12 +176,12 @@ void Vimeo::setClientId(const QString &id) {
 }
 
 QString Vimeo::clientSecret() const {
-    return QSettings().value("Vimeo/clientSecret", CLIENT_SECRET).toString();
+    return Settings::instance()->value("Vimeo/clientSecret", CLIENT_SECRET).toString();
 }
 
 void Vimeo::setClientSecret(const QString &secret) {
     if (secret != clientSecret()) {
-        QSettings().setValue("Vimeo/clientSecret", secret);
+        Settings::instance()->setValue("Vimeo/clientSecret", secret);
         emit clientSecretChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -169,12 +190,12 @@ void Vimeo::setClientSecret(const QString &secret) {
 }
 
 QString Vimeo::redirectUri() const {
-    return QSettings().value("Vimeo/redirectUri", REDIRECT_URI).toString();
+    return Settings::instance()->value("Vimeo/redirectUri", REDIRECT_URI).toString();
 }
 
 void Vimeo::setRedirectUri(const QString &uri) {
     if (uri != redirectUri()) {
-        QSettings().setValue("Vimeo/redirectUri", uri);
+        Settings::instance()->setValue("Vimeo/redirectUri", uri);
         emit redirectUriChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -183,12 +204,12 @@ void Vimeo::setRedirectUri(const QString &uri) {
 }
 
 QStringList Vimeo::scopes() const {
-    return QSettings().value("Vimeo/scopes", SCOPES).toStringList();
+    return Settings::instance()->value("Vimeo/scopes", SCOPES).toStringList();
 }
 
 void Vimeo::setScopes(const QStringList &s) {
     if (s != scopes()) {
-        QSettings().setValue("Vimeo/scopes", s);
+        Settings::instance()->setValue("Vimeo/scopes", s);
         emit scopesChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -201,19 +222,7 @@ bool Vimeo::hasScope(const QString &scope) const {
         return false;
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT scopes FROM vimeoAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "Vimeo::hasScope: database error:" << query.lastError().text();
-        return false;
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString().contains(scope);
-    }
-    
-    return false;
+    return account(userId()).scopes.contains(scope);
 }
 
 QString Vimeo::createScope() {
@@ -54,6 +54,8 @@ public:
     static const QRegExp URL_REGEXP;
     
     static Vimeo* instance();
+    
+    static void reloadAccounts();
         
     Q_INVOKABLE static QString getErrorString(const QVariantMap &error);
     
@@ -129,6 +131,24 @@ private:
         }
     };
     
+    struct Account {
+        QString accessToken;
+        QString scopes;
+    };
+    
+    struct AccountCache {
+        QHash<QString, Account> accounts;
+        bool loaded;
+        
+        AccountCache() :
+            loaded(false)
+        {
+        }
+    };
+    
+    static Account account(const QString &userId);
+    
+    static AccountCache accountCache;
     static SubscriptionCache subscriptionCache;
     static Vimeo *self;
     
@@ -15,6 +15,7 @@
  */
 
 #include "vimeoaccountmodel.h"
+#include "responsecache.h"
 #include "vimeo.h"
 #include <QSqlRecord>
 #include <QSqlField>
@@ -86,6 +87,8 @@ bool VimeoAccountModel::addAccount(const QString &userId, const QString &usernam
     record.append(scopesField);
     
     if (insertRecord(-1, record)) {
+        Vimeo::reloadAccounts();
+        ResponseCache::instance()->clear();
         Vimeo::instance()->setUserId(userId);
         const int count = rowCount();
         emit dataChanged(index(0, 0), index(count - 1, columnCount() - 1));
@@ -100,6 +103,9 @@ bool VimeoAccountModel::removeAccount(int row) {
     QString userId = data(index(row, 0)).toString();
     
     if (removeRows(row, 1)) {
+        Vimeo::reloadAccounts();
+        ResponseCache::instance()->clear();
+        
         if (userId == Vimeo::instance()->userId()) {
             if (rowCount() > 0) {
                 selectAccount(0);
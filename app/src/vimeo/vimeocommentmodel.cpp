@@ -21,19 +21,23 @@
 #endif
 
 VimeoCommentModel::VimeoCommentModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QVimeo::ResourcesRequest(this))
 {
-    m_roles[BodyRole] = "body";
-    m_roles[DateRole] = "date";
-    m_roles[IdRole] = "id";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoIdRole] = "videoId";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<VimeoComment> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BodyRole, "body", &CTComment::body);
+        roles.insert(DateRole, "date", &CTComment::date);
+        roles.insert(IdRole, "id", &CTComment::id);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTComment::thumbnailUrl);
+        roles.insert(UserIdRole, "userId", &CTComment::userId);
+        roles.insert(UsernameRole, "username", &CTComment::username);
+        roles.insert(VideoIdRole, "videoId", &CTComment::videoId);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setClientId(Vimeo::instance()->clientId());
     m_request->setClientSecret(Vimeo::instance()->clientSecret());
     m_request->setAccessToken(Vimeo::instance()->accessToken());
@@ -52,12 +56,6 @@ QVimeo::ResourcesRequest::Status VimeoCommentModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> VimeoCommentModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int VimeoCommentModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -77,49 +75,6 @@ void VimeoCommentModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant VimeoCommentModel::data(const QModelIndex &index, int role) const {
-    if (VimeoComment *comment = get(index.row())) {
-        return comment->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> VimeoCommentModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (VimeoComment *comment = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = comment->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant VimeoCommentModel::data(int row, const QByteArray &role) const {
-    if (VimeoComment *comment = get(row)) {
-        return comment->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap VimeoCommentModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (VimeoComment *comment = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = comment->property(role);
-        }
-    }
-    
-    return map;
-}
-
 VimeoComment* VimeoCommentModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
@@ -21,23 +21,27 @@
 #endif
 
 VimeoPlaylistModel::VimeoPlaylistModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QVimeo::ResourcesRequest(this)),
     m_hasMore(false)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[PrivacyRole] = "privacy";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoCountRole] = "videoCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<VimeoPlaylist> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTPlaylist::date);
+        roles.insert(DescriptionRole, "description", &CTPlaylist::description);
+        roles.insert(IdRole, "id", &CTPlaylist::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTPlaylist::largeThumbnailUrl);
+        roles.insert(PrivacyRole, "privacy", &VimeoPlaylist::privacy);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTPlaylist::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTPlaylist::title);
+        roles.insert(UserIdRole, "userId", &CTPlaylist::userId);
+        roles.insert(UsernameRole, "username", &CTPlaylist::username);
+        roles.insert(VideoCountRole, "videoCount", &CTPlaylist::videoCount);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setClientId(Vimeo::instance()->clientId());
     m_request->setClientSecret(Vimeo::instance()->clientSecret());
     m_request->setAccessToken(Vimeo::instance()->accessToken());
@@ -54,12 +58,6 @@ QVimeo::ResourcesRequest::Status VimeoPlaylistModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> VimeoPlaylistModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int VimeoPlaylistModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -79,49 +77,6 @@ void VimeoPlaylistModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant VimeoPlaylistModel::data(const QModelIndex &index, int role) const {
-    if (VimeoPlaylist *playlist = get(index.row())) {
-        return playlist->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> VimeoPlaylistModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (VimeoPlaylist *playlist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = playlist->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant VimeoPlaylistModel::data(int row, const QByteArray &role) const {
-    if (VimeoPlaylist *playlist = get(row)) {
-        return playlist->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap VimeoPlaylistModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (VimeoPlaylist *playlist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = playlist->property(role);
-        }
-    }
-    
-    return map;
-}
-
 VimeoPlaylist* VimeoPlaylistModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
@@ -18,9 +18,9 @@
 #define VIMEOPLAYLISTMODEL_H
 
 #include "vimeoplaylist.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class VimeoPlaylistModel : public QAbstractListModel
+class VimeoPlaylistModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -49,20 +49,11 @@ public:
     
     QVimeo::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE VimeoPlaylist* get(int row) const;
     
     Q_INVOKABLE void list(const QString &resourcePath, const QVariantMap &filters = QVariantMap());
@@ -94,8 +85,6 @@ private:
     bool m_hasMore;
         
     QList<VimeoPlaylist*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // VIMEOPLAYLISTMODEL_H
@@ -15,10 +15,13 @@
  */
 
 #include "vimeostreammodel.h"
+#include "resources.h"
+#include "streamcache.h"
 
 VimeoStreamModel::VimeoStreamModel(QObject *parent) :
     SelectionModel(parent),
-    m_request(new QVimeo::StreamsRequest(this))
+    m_request(new QVimeo::StreamsRequest(this)),
+    m_status(m_request->status())
 {
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -28,7 +31,7 @@ QString VimeoStreamModel::errorString() const {
 }
 
 QVimeo::StreamsRequest::Status VimeoStreamModel::status() const {
-    return m_request->status();
+    return m_status;
 }
 
 void VimeoStreamModel::list(const QString &id) {
@@ -38,27 +41,48 @@ void VimeoStreamModel::list(const QString &id) {
     
     clear();
     m_id = id;
-    m_request->list(id);
+    const QVariantList streams = StreamCache::instance()->streams(Resources::VIMEO, id);
+    
+    if (!streams.isEmpty()) {
+        loadStreams(streams);
+        m_status = QVimeo::StreamsRequest::Ready;
+    }
+    else {
+        m_request->list(id);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
 }
 
 void VimeoStreamModel::cancel() {
     m_request->cancel();
+    m_status = m_request->status();
 }
 
 void VimeoStreamModel::reload() {
+    StreamCache::instance()->remove(Resources::VIMEO, m_id);
     clear();
     m_request->list(m_id);
+    m_status = m_request->status();
     emit statusChanged(status());
 }
 
+void VimeoStreamModel::loadStreams(const QVariantList &streams) {
+    foreach (QVariant v, streams) {
+        QVariantMap stream = v.toMap();
+        append(QString("%1p %2").arg(stream.value("height").toInt()).arg(stream.value("description").toString()),
+               stream);
+    }
+}
+
 void VimeoStreamModel::onRequestFinished() {
-    if (m_request->status() == QVimeo::StreamsRequest::Ready) {
-        foreach (QVariant v, m_request->result().toList()) {
-            QVariantMap stream = v.toMap();
-            append(QString("%1p %2").arg(stream.value("height").toInt()).arg(stream.value("description").toString()),
-                   stream);
-        }
+    m_status = m_request->status();
+    
+    if (m_status == QVimeo::StreamsRequest::Ready) {
+        const QVariantList streams = m_request->result().toList();
+        StreamCache::instance()->insert(Resources::VIMEO, m_id, streams);
+        loadStreams(streams);
     }
     
     emit statusChanged(status());
@@ -40,6 +40,9 @@ public Q_SLOTS:
     void cancel();
     void reload();
 
+private:
+    void loadStreams(const QVariantList &streams);
+    
 private Q_SLOTS:
     void onRequestFinished();
     
@@ -48,6 +51,7 @@ Q_SIGNALS:
         
 private:
     QVimeo::StreamsRequest *m_request;
+    QVimeo::StreamsRequest::Status m_status;
     
     QString m_id;
 };
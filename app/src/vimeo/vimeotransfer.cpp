@@ -15,6 +15,8 @@
  */
 
 #include "vimeotransfer.h"
+#include "resources.h"
+#include "streamcache.h"
 #include "vimeo.h"
 #include <qvimeo/resourcesrequest.h>
 #include <qvimeo/streamsrequest.h>
@@ -27,9 +29,17 @@ VimeoTransfer::VimeoTransfer(QObject *parent) :
     m_streamsRequest(0),
     m_subtitlesRequest(0)
 {
+    setService(Resources::VIMEO);
 }
 
 void VimeoTransfer::listStreams() {
+    const QVariantMap stream = selectStream(StreamCache::instance()->streams(service(), resourceId()));
+    
+    if (!stream.isEmpty()) {
+        startDownload(stream.value("url").toString());
+        return;
+    }
+    
     if (!m_streamsRequest) {
         m_streamsRequest = new QVimeo::StreamsRequest(this);
         connect(m_streamsRequest, SIGNAL(finished()), this, SLOT(onStreamsRequestFinished()));
@@ -53,14 +63,12 @@ void VimeoTransfer::listSubtitles() {
 void VimeoTransfer::onStreamsRequestFinished() {
     if (m_streamsRequest->status() == QVimeo::StreamsRequest::Ready) {
         QVariantList list = m_streamsRequest->result().toList();
+        StreamCache::instance()->insert(service(), resourceId(), list);
+        const QVariantMap stream = selectStream(list);
         
-        foreach (QVariant v, list) {
-            QVariantMap stream = v.toMap();
-        
-            if (stream.value("id") == streamId()) {
-                startDownload(stream.value("url").toString());
-                return;
-            }
+        if (!stream.isEmpty()) {
+            startDownload(stream.value("url").toString());
+            return;
         }
     }
     
@@ -84,10 +92,5 @@ void VimeoTransfer::onSubtitlesRequestFinished() {
 #ifdef CUTETUBE_DEBUG
     qDebug() << "VimeoTransfer::onSubtitlesRequestFinished: No subtitles found";
 #endif
-    if (convertToAudio()) {
-        startAudioConversion();
-    }
-    else {
-        moveDownloadedFiles();
-    }
+    finishSubtitlesDownload();
 }
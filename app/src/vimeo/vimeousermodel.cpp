@@ -21,21 +21,25 @@
 #endif
 
 VimeoUserModel::VimeoUserModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QVimeo::ResourcesRequest(this))
 {
-    m_roles[BannerUrlRole] = "bannerUrl";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeBannerUrlRole] = "largeBannerUrl";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[SubscribedRole] = "subscribed";
-    m_roles[SubscriberCountRole] = "subscriberCount";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UsernameRole] = "username";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<VimeoUser> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BannerUrlRole, "bannerUrl");
+        roles.insert(DescriptionRole, "description", &CTUser::description);
+        roles.insert(IdRole, "id", &CTUser::id);
+        roles.insert(LargeBannerUrlRole, "largeBannerUrl");
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTUser::largeThumbnailUrl);
+        roles.insert(SubscribedRole, "subscribed", &VimeoUser::isSubscribed);
+        roles.insert(SubscriberCountRole, "subscriberCount", &VimeoUser::subscriberCount);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTUser::thumbnailUrl);
+        roles.insert(UsernameRole, "username", &CTUser::username);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setClientId(Vimeo::instance()->clientId());
     m_request->setClientSecret(Vimeo::instance()->clientSecret());
     m_request->setAccessToken(Vimeo::instance()->accessToken());
@@ -52,12 +56,6 @@ QVimeo::ResourcesRequest::Status VimeoUserModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> VimeoUserModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int VimeoUserModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -77,49 +75,6 @@ void VimeoUserModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant VimeoUserModel::data(const QModelIndex &index, int role) const {
-    if (VimeoUser *user = get(index.row())) {
-        return user->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> VimeoUserModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (VimeoUser *user = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = user->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant VimeoUserModel::data(int row, const QByteArray &role) const {
-    if (VimeoUser *user = get(row)) {
-        return user->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap VimeoUserModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (VimeoUser *user = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = user->property(role);
-        }
-    }
-    
-    return map;
-}
-
 VimeoUser* VimeoUserModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
@@ -18,9 +18,9 @@
 #define VIMEOUSERMODEL_H
 
 #include "vimeouser.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
-class VimeoUserModel : public QAbstractListModel
+class VimeoUserModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -49,20 +49,11 @@ public:
     
     QVimeo::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE VimeoUser* get(int row) const;
     
     Q_INVOKABLE void list(const QString &resourcePath, const QVariantMap &filters = QVariantMap());
@@ -95,8 +86,6 @@ private:
     bool m_hasMore;
         
     QList<VimeoUser*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // VIMEOUSERMODEL_H
@@ -23,16 +23,16 @@
 #include <QDebug>
 #endif
 
+VideoRegistry<VimeoVideo> VimeoVideo::registry;
+
 VimeoVideo::VimeoVideo(QObject *parent) :
     CTVideo(parent),
     m_request(0),
     m_favourite(false)
 {
     setService(Resources::VIMEO);
-    connect(Vimeo::instance(), SIGNAL(videoFavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
-    connect(Vimeo::instance(), SIGNAL(videoUnfavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 VimeoVideo::VimeoVideo(const QString &id, QObject *parent) :
@@ -42,10 +42,8 @@ VimeoVideo::VimeoVideo(const QString &id, QObject *parent) :
 {
     setService(Resources::VIMEO);
     loadVideo(id);
-    connect(Vimeo::instance(), SIGNAL(videoFavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
-    connect(Vimeo::instance(), SIGNAL(videoUnfavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 VimeoVideo::VimeoVideo(const QVariantMap &video, QObject *parent) :
@@ -55,10 +53,8 @@ VimeoVideo::VimeoVideo(const QVariantMap &video, QObject *parent) :
 {
     setService(Resources::VIMEO);
     loadVideo(video);
-    connect(Vimeo::instance(), SIGNAL(videoFavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
-    connect(Vimeo::instance(), SIGNAL(videoUnfavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 VimeoVideo::VimeoVideo(const VimeoVideo *video, QObject *parent) :
@@ -66,10 +62,12 @@ VimeoVideo::VimeoVideo(const VimeoVideo *video, QObject *parent) :
     m_request(0),
     m_favourite(video->isFavourite())
 {
-    connect(Vimeo::instance(), SIGNAL(videoFavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
-    connect(Vimeo::instance(), SIGNAL(videoUnfavourited(VimeoVideo*)),
-            this, SLOT(onVideoUpdated(VimeoVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+}
+
+VimeoVideo::~VimeoVideo() {
+    registry.remove(this);
 }
 
 QString VimeoVideo::errorString() const {
@@ -203,6 +201,7 @@ void VimeoVideo::onFavouriteRequestFinished() {
     if (m_request->status() == QVimeo::ResourcesRequest::Ready) {
         setFavourite(true);
         setFavouriteCount(favouriteCount() + 1);
+        registry.update(this);
         emit Vimeo::instance()->videoFavourited(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "VimeoVideo::onFavouriteRequestFinished OK" << id();
@@ -217,6 +216,7 @@ void VimeoVideo::onUnfavouriteRequestFinished() {
     if (m_request->status() == QVimeo::ResourcesRequest::Ready) {
         setFavourite(false);
         setFavouriteCount(favouriteCount() - 1);
+        registry.update(this);
         emit Vimeo::instance()->videoUnfavourited(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "VimeoVideo::onUnfavouriteRequestFinished OK" << id();
@@ -239,8 +239,6 @@ void VimeoVideo::onWatchLaterRequestFinished() {
     emit statusChanged(status());
 }
 
-void VimeoVideo::onVideoUpdated(VimeoVideo *video) {
-    if ((video->id() == id()) && (video != this)) {
-        loadVideo(video);
-    }
+void VimeoVideo::onIdChanged() {
+    registry.insert(this);
 }
@@ -18,6 +18,7 @@
 #define VIMEOVIDEO_H
 
 #include "video.h"
+#include "videoregistry.h"
 #include <qvimeo/resourcesrequest.h>
 
 class VimeoVideo : public CTVideo
@@ -34,6 +35,7 @@ public:
     explicit VimeoVideo(const QString &id, QObject *parent = 0);
     explicit VimeoVideo(const QVariantMap &video, QObject *parent = 0);
     explicit VimeoVideo(const VimeoVideo *video, QObject *parent = 0);
+    ~VimeoVideo();
     
     QString errorString() const;
     
@@ -63,7 +65,7 @@ private Q_SLOTS:
     void onFavouriteRequestFinished();
     void onUnfavouriteRequestFinished();
     void onWatchLaterRequestFinished();
-    void onVideoUpdated(VimeoVideo *video);
+    void onIdChanged();
     
 Q_SIGNALS:
     void favouriteChanged();
@@ -71,6 +73,8 @@ Q_SIGNALS:
     void statusChanged(QVimeo::ResourcesRequest::Status s);
 
 private:
+    static VideoRegistry<VimeoVideo> registry;
+    
     QVimeo::ResourcesRequest *m_request;
     
     bool m_favourite;
@@ -17,34 +17,47 @@
 #include "vimeovideomodel.h"
 #include "vimeo.h"
 #include "vimeoplaylist.h"
+#include "resources.h"
+#include "responsecache.h"
+#include "settings.h"
 #ifdef CUTETUBE_DEBUG
 #include <QDebug>
 #endif
 
 VimeoVideoModel::VimeoVideoModel(QObject *parent) :
-    QAbstractListModel(parent),
-    m_request(new QVimeo::ResourcesRequest(this))
+    RoleListModel(parent),
+    m_request(new QVimeo::ResourcesRequest(this)),
+    m_prefetchRequest(0),
+    m_status(m_request->status()),
+    m_hasMore(false),
+    m_revalidating(false),
+    m_prefetchPage(0),
+    m_prefetchHasMore(false),
+    m_prefetchReady(false),
+    m_prefetchWaiting(false),
+    m_prefetchFailed(false),
+    m_prefetchQueued(false)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DurationRole] = "duration";
-    m_roles[FavouriteRole] = "favourited";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[ViewCountRole] = "viewCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
-    m_request->setClientId(Vimeo::instance()->clientId());
-    m_request->setClientSecret(Vimeo::instance()->clientSecret());
-    m_request->setAccessToken(Vimeo::instance()->accessToken());
+    static RoleTable<VimeoVideo> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTVideo::date);
+        roles.insert(DescriptionRole, "description", &CTVideo::description);
+        roles.insert(DurationRole, "duration", &CTVideo::duration);
+        roles.insert(FavouriteRole, "favourited", &VimeoVideo::isFavourite);
+        roles.insert(IdRole, "id", &CTVideo::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTVideo::largeThumbnailUrl);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTVideo::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTVideo::title);
+        roles.insert(UrlRole, "url", &CTVideo::url);
+        roles.insert(UserIdRole, "userId", &CTVideo::userId);
+        roles.insert(UsernameRole, "username", &CTVideo::username);
+        roles.insert(ViewCountRole, "viewCount", &CTVideo::viewCount);
+    }
+    
+    setRoleTable(&roles);
     
-    connect(m_request, SIGNAL(accessTokenChanged(QString)), Vimeo::instance(), SLOT(setAccessToken(QString)));
+    initRequest(m_request);
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
 
@@ -53,14 +66,12 @@ QString VimeoVideoModel::errorString() const {
 }
 
 QVimeo::ResourcesRequest::Status VimeoVideoModel::status() const {
-    return m_request->status();
-}
-
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> VimeoVideoModel::roleNames() const {
-    return m_roles;
+    if ((m_prefetchWaiting) && (isPrefetching())) {
+        return QVimeo::ResourcesRequest::Loading;
+    }
+    
+    return m_status;
 }
-#endif
 
 int VimeoVideoModel::rowCount(const QModelIndex &) const {
     return m_items.size();
@@ -75,53 +86,32 @@ void VimeoVideoModel::fetchMore(const QModelIndex &) {
         return;
     }
     
-    const int page = m_filters.value("page").toInt();
-    m_filters["page"] = (page > 0 ? page + 1 : 2);
-    m_request->list(m_resourcePath, m_filters);
-    emit statusChanged(status());
-}
-
-QVariant VimeoVideoModel::data(const QModelIndex &index, int role) const {
-    if (VimeoVideo *video = get(index.row())) {
-        return video->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> VimeoVideoModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
+    m_prefetchFailed = false;
     
-    if (VimeoVideo *video = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = video->property(iterator.value());
-        }
+    if (m_prefetchReady) {
+        loadPrefetchedResults();
+        return;
     }
     
-    return map;
-}
-
-QVariant VimeoVideoModel::data(int row, const QByteArray &role) const {
-    if (VimeoVideo *video = get(row)) {
-        return video->property(role);
+    if (isPrefetching()) {
+        m_prefetchWaiting = true;
+        emit statusChanged(status());
+        return;
     }
     
-    return QVariant();
+    const int page = m_filters.value("page").toInt();
+    m_filters["page"] = (page > 0 ? page + 1 : 2);
+    m_request->list(m_resourcePath, m_filters);
+    m_status = m_request->status();
+    emit statusChanged(status());
 }
 
-QVariantMap VimeoVideoModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (VimeoVideo *video = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = video->property(role);
-        }
+QVariant VimeoVideoModel::data(const QModelIndex &index, int role) const {
+    if (get(index.row())) {
+        prefetchIfNeeded(index.row());
     }
     
-    return map;
+    return RoleListModel::data(index, role);
 }
 
 VimeoVideo* VimeoVideoModel::get(int row) const {
@@ -140,7 +130,15 @@ void VimeoVideoModel::list(const QString &resourcePath, const QVariantMap &filte
     clear();
     m_resourcePath = resourcePath;
     m_filters = filters;
-    m_request->list(resourcePath, filters);
+    
+    if (loadCachedResult()) {
+        m_status = QVimeo::ResourcesRequest::Ready;
+    }
+    else {
+        m_request->list(resourcePath, filters);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
     
     disconnect(Vimeo::instance(), 0, this, 0);
@@ -164,6 +162,9 @@ void VimeoVideoModel::list(const QString &resourcePath, const QVariantMap &filte
 }
 
 void VimeoVideoModel::clear() {
+    cancelPrefetch();
+    m_prefetchFailed = false;
+    
     if (!m_items.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
@@ -175,15 +176,155 @@ void VimeoVideoModel::clear() {
 }
 
 void VimeoVideoModel::cancel() {
+    cancelPrefetch();
     m_request->cancel();
 }
 
 void VimeoVideoModel::reload() {
     clear();
+    m_cacheKey = cacheKey();
     m_request->list(m_resourcePath, m_filters);
+    m_status = m_request->status();
     emit statusChanged(status());
 }
 
+void VimeoVideoModel::initRequest(QVimeo::ResourcesRequest *request) {
+    request->setClientId(Vimeo::instance()->clientId());
+    request->setClientSecret(Vimeo::instance()->clientSecret());
+    request->setAccessToken(Vimeo::instance()->accessToken());
+    
+    connect(request, SIGNAL(accessTokenChanged(QString)), Vimeo::instance(), SLOT(setAccessToken(QString)));
+}
+
+QString VimeoVideoModel::cacheKey() const {
+    return ResponseCache::cacheKey(Resources::VIMEO, m_resourcePath, m_filters, QVariantMap(), Vimeo::instance()->userId());
+}
+
+bool VimeoVideoModel::loadCachedResult() {
+    bool stale = false;
+    m_cacheKey = cacheKey();
+    const QVariantMap result = ResponseCache::instance()->result(m_cacheKey, &stale).toMap();
+    
+    if (result.isEmpty()) {
+        return false;
+    }
+    
+    loadResult(result);
+    
+    if (stale) {
+        m_revalidating = true;
+        return false;
+    }
+    
+    m_cacheKey = QString();
+    return true;
+}
+
+void VimeoVideoModel::loadResult(const QVariantMap &result) {
+    m_hasMore = !result.value("paging").toMap().value("next").isNull();
+    const QVariantList list = result.value("data").toList();
+    
+    if (!list.isEmpty()) {
+        loadResults(list);
+    }
+}
+
+void VimeoVideoModel::loadResults(const QVariantList &list) {
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
+    
+    if (m_resourcePath.endsWith("/feed")) {
+        foreach (QVariant item, list) {
+            m_items << new VimeoVideo(item.toMap().value("clip").toMap(), this);
+        }
+    }
+    else {
+        foreach (QVariant item, list) {
+            m_items << new VimeoVideo(item.toMap(), this);
+        }
+    }
+
+    endInsertRows();
+    emit countChanged(rowCount());
+}
+
+bool VimeoVideoModel::isPrefetching() const {
+    return (m_prefetchRequest) && (m_prefetchRequest->status() == QVimeo::ResourcesRequest::Loading);
+}
+
+void VimeoVideoModel::prefetchIfNeeded(int row) const {
+    if ((m_prefetchReady) || (m_prefetchFailed) || (m_prefetchQueued) || (!m_hasMore) || (isPrefetching())) {
+        return;
+    }
+    
+    const int threshold = Settings::instance()->prefetchThreshold();
+    
+    if ((threshold > 0) && (row >= m_items.size() - threshold)) {
+        m_prefetchQueued = true;
+        QMetaObject::invokeMethod(const_cast<VimeoVideoModel*>(this), "prefetch", Qt::QueuedConnection);
+    }
+}
+
+void VimeoVideoModel::prefetch() {
+    m_prefetchQueued = false;
+    
+    if ((m_prefetchReady) || (!m_hasMore) || (isPrefetching()) || (status() == QVimeo::ResourcesRequest::Loading)) {
+        return;
+    }
+    
+    if (!m_prefetchRequest) {
+        m_prefetchRequest = new QVimeo::ResourcesRequest(this);
+        initRequest(m_prefetchRequest);
+        connect(m_prefetchRequest, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+    }
+    
+    const int page = m_filters.value("page").toInt();
+    m_prefetchPage = (page > 0 ? page + 1 : 2);
+    QVariantMap filters = m_filters;
+    filters["page"] = m_prefetchPage;
+    m_prefetchRequest->list(m_resourcePath, filters);
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "VimeoVideoModel::prefetch" << m_resourcePath << m_prefetchPage;
+#endif
+}
+
+void VimeoVideoModel::cancelPrefetch() {
+    m_prefetchWaiting = false;
+    m_prefetchReady = false;
+    m_prefetchResults.clear();
+    
+    if (m_prefetchRequest) {
+        m_prefetchRequest->cancel();
+    }
+}
+
+void VimeoVideoModel::loadPrefetchedResults() {
+    const QVariantList list = m_prefetchResults;
+    m_filters["page"] = m_prefetchPage;
+    m_hasMore = m_prefetchHasMore;
+    m_prefetchResults.clear();
+    m_prefetchReady = false;
+    m_prefetchWaiting = false;
+    
+    if (!list.isEmpty()) {
+        loadResults(list);
+    }
+    
+    emit statusChanged(status());
+}
+
+void VimeoVideoModel::finishPrefetch() {
+    if (m_prefetchWaiting) {
+        m_prefetchWaiting = false;
+        
+        if (m_prefetchReady) {
+            loadPrefetchedResults();
+        }
+        else {
+            fetchMore();
+        }
+    }
+}
+
 void VimeoVideoModel::append(VimeoVideo *video) {
     beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
     m_items << video;
@@ -214,32 +355,50 @@ void VimeoVideoModel::onRequestFinished() {
         QVariantMap result = m_request->result().toMap();
         
         if (!result.isEmpty()) {
-            m_hasMore = !result.value("paging").toMap().value("next").isNull();
-            QVariantList list = result.value("data").toList();
-
-            beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
-    
-            if (m_resourcePath.endsWith("/feed")) {
-                foreach (QVariant item, list) {
-                    m_items << new VimeoVideo(item.toMap().value("clip").toMap(), this);
-                }
+            const bool changed = (!m_revalidating) || (result != ResponseCache::instance()->result(m_cacheKey).toMap());
+            
+            if (!m_cacheKey.isEmpty()) {
+                ResponseCache::instance()->insert(m_cacheKey, result,
+                                                  ResponseCache::timeToLive(m_resourcePath, m_filters));
             }
-            else {
-                foreach (QVariant item, list) {
-                    m_items << new VimeoVideo(item.toMap(), this);
+            
+            if (changed) {
+                if (m_revalidating) {
+                    clear();
                 }
+                
+                loadResult(result);
             }
-
-            endInsertRows();
-            emit countChanged(rowCount());
         }
     }
     
+    // A failed revalidation keeps showing the cached page
+    m_status = m_revalidating ? QVimeo::ResourcesRequest::Ready : m_request->status();
+    m_cacheKey = QString();
+    m_revalidating = false;
     emit statusChanged(status());
 }
 
+void VimeoVideoModel::onPrefetchRequestFinished() {
+    m_prefetchFailed = (m_prefetchRequest->status() == QVimeo::ResourcesRequest::Failed);
+    
+    if (m_prefetchRequest->status() == QVimeo::ResourcesRequest::Ready) {
+        QVariantMap result = m_prefetchRequest->result().toMap();
+        
+        if (!result.isEmpty()) {
+            m_prefetchHasMore = !result.value("paging").toMap().value("next").isNull();
+            m_prefetchResults = result.value("data").toList();
+            m_prefetchReady = true;
+        }
+    }
+    
+    finishPrefetch();
+}
+
 void VimeoVideoModel::onVideoAddedToPlaylist(VimeoVideo *video, VimeoPlaylist *playlist) {
     if (m_resourcePath.section('/', -2, -2) == playlist->id()) {
+        ResponseCache::instance()->remove(cacheKey());
+        
         insert(0, new VimeoVideo(video, this));
     }
 #ifdef CUTETUBE_DEBUG
@@ -249,6 +408,8 @@ void VimeoVideoModel::onVideoAddedToPlaylist(VimeoVideo *video, VimeoPlaylist *p
 
 void VimeoVideoModel::onVideoRemovedFromPlaylist(VimeoVideo *video, VimeoPlaylist *playlist) {
     if (m_resourcePath.section('/', -2, -2) == playlist->id()) {
+        ResponseCache::instance()->remove(cacheKey());
+        
         QModelIndexList list = match(index(0), IdRole, video->id(), 1, Qt::MatchExactly);
         
         if (!list.isEmpty()) {
@@ -261,6 +422,8 @@ void VimeoVideoModel::onVideoRemovedFromPlaylist(VimeoVideo *video, VimeoPlaylis
 }
 
 void VimeoVideoModel::onVideoFavourited(VimeoVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     insert(0, new VimeoVideo(video, this));
 #ifdef CUTETUBE_DEBUG
     qDebug() << "VimeoVideoModel::onVideoFavourited" << video->id();
@@ -268,6 +431,8 @@ void VimeoVideoModel::onVideoFavourited(VimeoVideo *video) {
 }
 
 void VimeoVideoModel::onVideoUnfavourited(VimeoVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     QModelIndexList list = match(index(0), IdRole, video->id(), 1, Qt::MatchExactly);
     
     if (!list.isEmpty()) {
@@ -279,6 +444,8 @@ void VimeoVideoModel::onVideoUnfavourited(VimeoVideo *video) {
 }
 
 void VimeoVideoModel::onVideoWatchLater(VimeoVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     insert(0, new VimeoVideo(video, this));
 #ifdef CUTETUBE_DEBUG
     qDebug() << "VimeoVideoModel::onVideoWatchLater" << video->id();
@@ -18,11 +18,11 @@
 #define VIMEOVIDEOMODEL_H
 
 #include "vimeovideo.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 
 class VimeoPlaylist;
 
-class VimeoVideoModel : public QAbstractListModel
+class VimeoVideoModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -53,19 +53,13 @@ public:
     
     QVimeo::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
+    using RoleListModel::data;
     QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
     
     Q_INVOKABLE VimeoVideo* get(int row) const;
     
@@ -77,12 +71,26 @@ public Q_SLOTS:
     void reload();
     
 private:
+    void initRequest(QVimeo::ResourcesRequest *request);
+    QString cacheKey() const;
+    bool loadCachedResult();
+    void loadResult(const QVariantMap &result);
+    void loadResults(const QVariantList &list);
+    
+    bool isPrefetching() const;
+    void prefetchIfNeeded(int row) const;
+    void cancelPrefetch();
+    void loadPrefetchedResults();
+    void finishPrefetch();
+    
     void append(VimeoVideo *video);
     void insert(int row, VimeoVideo *video);
     void remove(int row);
     
 private Q_SLOTS:
     void onRequestFinished();
+    void prefetch();
+    void onPrefetchRequestFinished();
     void onVideoAddedToPlaylist(VimeoVideo *video, VimeoPlaylist *playlist);
     void onVideoRemovedFromPlaylist(VimeoVideo *video, VimeoPlaylist *playlist);
     void onVideoFavourited(VimeoVideo *video);
@@ -95,14 +103,26 @@ Q_SIGNALS:
     
 private:
     QVimeo::ResourcesRequest *m_request;
+    QVimeo::ResourcesRequest *m_prefetchRequest;
+    
+    QVimeo::ResourcesRequest::Status m_status;
     
     QString m_resourcePath;
     QVariantMap m_filters;
     bool m_hasMore;
+    
+    QString m_cacheKey;
+    bool m_revalidating;
+    
+    QVariantList m_prefetchResults;
+    int m_prefetchPage;
+    bool m_prefetchHasMore;
+    bool m_prefetchReady;
+    bool m_prefetchWaiting;
+    bool m_prefetchFailed;
+    mutable bool m_prefetchQueued;
         
     QList<VimeoVideo*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // VIMEOVIDEOMODEL_H
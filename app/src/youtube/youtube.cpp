@@ -17,9 +17,9 @@
 #include "youtube.h"
 #include "database.h"
 #include "json.h"
+#include "jsonparser.h"
+#include "settings.h"
 #include <qyoutube/urls.h>
-#include <QSettings>
-#include <QSqlRecord>
 #if QT_VERSION >= 0x050000
 #include <QUrlQuery>
 #endif
@@ -35,6 +35,7 @@ static const QStringList SCOPES = QStringList() << QYouTube::READ_WRITE_SCOPE <<
 const QRegExp YouTube::URL_REGEXP("(http(s|)://(www.|m.|)youtube.com/(v/|.+)(v=|list=|)|http://youtu.be/)",
                                   Qt::CaseInsensitive);
 
+YouTube::AccountCache YouTube::accountCache;
 YouTube::SubscriptionCache YouTube::subscriptionCache;
 
 YouTube* YouTube::self = 0;
@@ -57,6 +58,34 @@ YouTube* YouTube::instance() {
     return self;
 }
 
+void YouTube::reloadAccounts() {
+    accountCache.accounts.clear();
+    accountCache.loaded = false;
+}
+
+YouTube::Account YouTube::account(const QString &userId) {
+    if (!accountCache.loaded) {
+        accountCache.loaded = true;
+        QSqlQuery query = getDatabase().exec("SELECT userId, accessToken, refreshToken, relatedPlaylists, scopes \
+                                              FROM youtubeAccounts");
+        
+        if (query.lastError().isValid()) {
+            qDebug() << "YouTube::account: database error:" << query.lastError().text();
+        }
+        
+        while (query.next()) {
+            Account account;
+            account.accessToken = query.value(1).toString();
+            account.refreshToken = query.value(2).toString();
+            account.relatedPlaylists = JsonParser::parse(query.value(3).toString().toUtf8()).toMap();
+            account.scopes = query.value(4).toString();
+            accountCache.accounts[query.value(0).toString()] = account;
+        }
+    }
+    
+    return accountCache.accounts.value(userId);
+}
+
 QString YouTube::formatDuration(const QString &duration) {    
     QStringList nums;
     QString num;
@@ -189,12 +218,12 @@ QUrl YouTube::authUrl() const {
 }
 
 QString YouTube::userId() const {
-    return QSettings().value("YouTube/userId").toString();
+    return Settings::instance()->value("YouTube/userId").toString();
 }
 
 void YouTube::setUserId(const QString &id) {
     if (id != userId()) {
-        QSettings().setValue("YouTube/userId", id);
+        Settings::instance()->setValue("YouTube/userId", id);
         subscriptionCache.ids.clear();
         subscriptionCache.nextPageToken = QString();
         subscriptionCache.loaded = false;
@@ -207,29 +236,25 @@ QString YouTube::accessToken() const {
         return QString();
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT accessToken FROM youtubeAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "YouTube::accessToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    return account(userId()).accessToken;
 }
 
 void YouTube::setAccessToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE youtubeAccounts SET accessToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE youtubeAccounts SET accessToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "YouTube::setAccessToken: database error:" << query.lastError().text();
     }
     else {
+        QHash<QString, Account>::iterator iterator = accountCache.accounts.find(userId());
+        
+        if (iterator != accountCache.accounts.end()) {
+            iterator.value().accessToken = token;
+        }
+        
         emit accessTokenChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -242,29 +267,25 @@ QString YouTube::refreshToken() const {
         return QString();
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT refreshToken FROM youtubeAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "YouTube::refreshToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    return account(userId()).refreshToken;
 }
 
 void YouTube::setRefreshToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE youtubeAccounts SET refreshToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE youtubeAccounts SET refreshToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "YouTube::setRefreshToken: database error:" << query.lastError().text();
     }
     else {
+        QHash<QString, Account>::iterator iterator = accountCache.accounts.find(userId());
+        
+        if (iterator != accountCache.accounts.end()) {
+            iterator.value().refreshToken = token;
+        }
+        
         emit refreshTokenChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -277,29 +298,25 @@ QVariantMap YouTube::relatedPlaylists() const {
         return QVariantMap();
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT relatedPlaylists FROM youtubeAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "YouTube::refreshToken: database error:" << query.lastError().text();
-        return QVariantMap();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return QtJson::Json::parse(query.value(0).toString()).toMap();
-    }
-    
-    return QVariantMap();
+    return account(userId()).relatedPlaylists;
 }
 
 void YouTube::setRelatedPlaylists(const QVariantMap &playlists) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE youtubeAccounts SET relatedPlaylists = '%1' WHERE userId = '%2'")
-                                                .arg(QString(QtJson::Json::serialize(playlists))).arg(userId()));
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE youtubeAccounts SET relatedPlaylists = ? WHERE userId = ?");
+    query.addBindValue(QString(QtJson::Json::serialize(playlists)));
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "YouTube::setRelatedPlaylists: database error:" << query.lastError().text();
     }
     else {
+        QHash<QString, Account>::iterator iterator = accountCache.accounts.find(userId());
+        
+        if (iterator != accountCache.accounts.end()) {
+            iterator.value().relatedPlaylists = playlists;
+        }
+        
         emit relatedPlaylistsChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -308,12 +325,12 @@ void YouTube::setRelatedPlaylists(const QVariantMap &playlists) {
 }
 
 QString YouTube::apiKey() const {
-    return QSettings().value("YouTube/apiKey", API_KEY).toString();
+    return Settings::instance()->value("YouTube/apiKey", API_KEY).toString();
 }
 
 void YouTube::setApiKey(const QString &key) {
     if (key != apiKey()) {
-        QSettings().setValue("YouTube/apiKey", key);
+        Settings::instance()->setValue("YouTube/apiKey", key);
         emit apiKeyChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -322,12 +339,12 @@ void YouTube::setApiKey(const QString &key) {
 }
 
 QString YouTube::clientId() const {
-    return QSettings().value("YouTube/clientId", CLIENT_ID).toString();
+    return Settings::instance()->value("YouTube/clientId", CLIENT_ID).toString();
 }
 
 void YouTube::setClientId(const QString &id) {
     if (id != clientId()) {
-        QSettings().setValue("YouTube/clientId", id);
+        Settings::instance()->setValue("YouTube/clientId", id);
         emit clientIdChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -336,12 +353,12 @@ void YouTube::setClientId(const QString &id) {
 }
 
 QString YouTube::clientSecret() const {
-    return QSettings().value("YouTube/clientSecret", CLIENT_SECRET).toString();
+    return Settings::instance()->value("YouTube/clientSecret", CLIENT_SECRET).toString();
 }
 
 void YouTube::setClientSecret(const QString &secret) {
     if (secret != clientSecret()) {
-        QSettings().setValue("YouTube/clientSecret", secret);
+        Settings::instance()->setValue("YouTube/clientSecret", secret);
         emit clientSecretChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -350,12 +367,12 @@ void YouTube::setClientSecret(const QString &secret) {
 }
 
 QStringList YouTube::scopes() const {
-    return QSettings().value("YouTube/scopes", SCOPES).toStringList();
+    return Settings::instance()->value("YouTube/scopes", SCOPES).toStringList();
 }
 
 void YouTube::setScopes(const QStringList &s) {
     if (s != scopes()) {
-        QSettings().setValue("YouTube/scopes", s);
+        Settings::instance()->setValue("YouTube/scopes", s);
         emit scopesChanged();
     }
 #ifdef CUTETUBE_DEBUG
@@ -368,19 +385,7 @@ bool YouTube::hasScope(const QString &scope) const {
         return false;
     }
     
-    QSqlQuery query = getDatabase().exec(QString("SELECT scopes FROM youtubeAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "YouTube::hasScope: database error:" << query.lastError().text();
-        return false;
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString().contains(scope);
-    }
-    
-    return false;
+    return account(userId()).scopes.contains(scope);
 }
 
 QString YouTube::auditScope() {
@@ -55,6 +55,8 @@ public:
     static const QRegExp URL_REGEXP;
     
     static YouTube* instance();
+    
+    static void reloadAccounts();
         
     Q_INVOKABLE static QString formatDuration(const QString &duration);
     
@@ -148,6 +150,26 @@ private:
         }
     };
     
+    struct Account {
+        QString accessToken;
+        QString refreshToken;
+        QVariantMap relatedPlaylists;
+        QString scopes;
+    };
+    
+    struct AccountCache {
+        QHash<QString, Account> accounts;
+        bool loaded;
+        
+        AccountCache() :
+            loaded(false)
+        {
+        }
+    };
+    
+    static Account account(const QString &userId);
+    
+    static AccountCache accountCache;
     static SubscriptionCache subscriptionCache;
     static YouTube *self;
     
@@ -16,6 +16,7 @@
 
 #include "youtubeaccountmodel.h"
 #include "json.h"
+#include "responsecache.h"
 #include "youtube.h"
 #include <QSqlRecord>
 #include <QSqlField>
@@ -98,6 +99,8 @@ bool YouTubeAccountModel::addAccount(const QString &userId, const QString &usern
     record.append(scopesField);
     
     if (insertRecord(-1, record)) {
+        YouTube::reloadAccounts();
+        ResponseCache::instance()->clear();
         YouTube::instance()->setUserId(userId);
         const int count = rowCount();
         emit dataChanged(index(0, 0), index(count - 1, columnCount() - 1));
@@ -112,6 +115,9 @@ bool YouTubeAccountModel::removeAccount(int row) {
     QString userId = data(index(row, 0)).toString();
     
     if (removeRows(row, 1)) {
+        YouTube::reloadAccounts();
+        ResponseCache::instance()->clear();
+        
         if (userId == YouTube::instance()->userId()) {
             if (rowCount() > 0) {
                 selectAccount(0);
@@ -21,20 +21,24 @@
 #endif
 
 YouTubeCommentModel::YouTubeCommentModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QYouTube::ResourcesRequest(this))
 {
-    m_roles[BodyRole] = "body";
-    m_roles[DateRole] = "date";
-    m_roles[IdRole] = "id";
-    m_roles[ParentIdRole] = "parentId";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoIdRole] = "videoId";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<YouTubeComment> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BodyRole, "body", &CTComment::body);
+        roles.insert(DateRole, "date", &CTComment::date);
+        roles.insert(IdRole, "id", &CTComment::id);
+        roles.insert(ParentIdRole, "parentId", &YouTubeComment::parentId);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTComment::thumbnailUrl);
+        roles.insert(UserIdRole, "userId", &CTComment::userId);
+        roles.insert(UsernameRole, "username", &CTComment::username);
+        roles.insert(VideoIdRole, "videoId", &CTComment::videoId);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setApiKey(YouTube::instance()->apiKey());
     m_request->setClientId(YouTube::instance()->clientId());
     m_request->setClientSecret(YouTube::instance()->clientSecret());
@@ -56,12 +60,6 @@ QYouTube::ResourcesRequest::Status YouTubeCommentModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> YouTubeCommentModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int YouTubeCommentModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -82,49 +80,6 @@ void YouTubeCommentModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant YouTubeCommentModel::data(const QModelIndex &index, int role) const {
-    if (YouTubeComment *comment = get(index.row())) {
-        return comment->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> YouTubeCommentModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (YouTubeComment *comment = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = comment->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant YouTubeCommentModel::data(int row, const QByteArray &role) const {
-    if (YouTubeComment *comment = get(row)) {
-        return comment->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap YouTubeCommentModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (YouTubeComment *comment = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = comment->property(role);
-        }
-    }
-    
-    return map;
-}
-
 YouTubeComment* YouTubeCommentModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
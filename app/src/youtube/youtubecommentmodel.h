@@ -18,10 +18,10 @@
 #define YOUTUBECOMMENTMODEL_H
 
 #include "youtubecomment.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 #include <QStringList>
 
-class YouTubeCommentModel : public QAbstractListModel
+class YouTubeCommentModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -48,20 +48,11 @@ public:
     
     QYouTube::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE YouTubeComment* get(int row) const;
     
     Q_INVOKABLE void list(const QString &resourcePath, const QStringList &part,
@@ -96,8 +87,6 @@ private:
     QString m_nextPageToken;
         
     QList<YouTubeComment*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // YOUTUBECOMMENTMODEL_H
@@ -21,22 +21,26 @@
 #endif
 
 YouTubePlaylistModel::YouTubePlaylistModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QYouTube::ResourcesRequest(this)),
     m_contentRequest(0)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[VideoCountRole] = "videoCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<YouTubePlaylist> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTPlaylist::date);
+        roles.insert(DescriptionRole, "description", &CTPlaylist::description);
+        roles.insert(IdRole, "id", &CTPlaylist::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTPlaylist::largeThumbnailUrl);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTPlaylist::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTPlaylist::title);
+        roles.insert(UserIdRole, "userId", &CTPlaylist::userId);
+        roles.insert(UsernameRole, "username", &CTPlaylist::username);
+        roles.insert(VideoCountRole, "videoCount", &CTPlaylist::videoCount);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setApiKey(YouTube::instance()->apiKey());
     m_request->setClientId(YouTube::instance()->clientId());
     m_request->setClientSecret(YouTube::instance()->clientSecret());
@@ -60,12 +64,6 @@ QYouTube::ResourcesRequest::Status YouTubePlaylistModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> YouTubePlaylistModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int YouTubePlaylistModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -86,49 +84,6 @@ void YouTubePlaylistModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant YouTubePlaylistModel::data(const QModelIndex &index, int role) const {
-    if (YouTubePlaylist *playlist = get(index.row())) {
-        return playlist->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> YouTubePlaylistModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (YouTubePlaylist *playlist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = playlist->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant YouTubePlaylistModel::data(int row, const QByteArray &role) const {
-    if (YouTubePlaylist *playlist = get(row)) {
-        return playlist->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap YouTubePlaylistModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (YouTubePlaylist *playlist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = playlist->property(role);
-        }
-    }
-    
-    return map;
-}
-
 YouTubePlaylist* YouTubePlaylistModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
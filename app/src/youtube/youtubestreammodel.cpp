@@ -15,10 +15,13 @@
  */
 
 #include "youtubestreammodel.h"
+#include "resources.h"
+#include "streamcache.h"
 
 YouTubeStreamModel::YouTubeStreamModel(QObject *parent) :
     SelectionModel(parent),
-    m_request(new QYouTube::StreamsRequest(this))
+    m_request(new QYouTube::StreamsRequest(this)),
+    m_status(m_request->status())
 {
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
@@ -28,7 +31,7 @@ QString YouTubeStreamModel::errorString() const {
 }
 
 QYouTube::StreamsRequest::Status YouTubeStreamModel::status() const {
-    return m_request->status();
+    return m_status;
 }
 
 void YouTubeStreamModel::list(const QString &id) {
@@ -38,27 +41,48 @@ void YouTubeStreamModel::list(const QString &id) {
     
     clear();
     m_id = id;
-    m_request->list(id);
+    const QVariantList streams = StreamCache::instance()->streams(Resources::YOUTUBE, id);
+    
+    if (!streams.isEmpty()) {
+        loadStreams(streams);
+        m_status = QYouTube::StreamsRequest::Ready;
+    }
+    else {
+        m_request->list(id);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
 }
 
 void YouTubeStreamModel::cancel() {
     m_request->cancel();
+    m_status = m_request->status();
 }
 
 void YouTubeStreamModel::reload() {
+    StreamCache::instance()->remove(Resources::YOUTUBE, m_id);
     clear();
     m_request->list(m_id);
+    m_status = m_request->status();
     emit statusChanged(status());
 }
 
+void YouTubeStreamModel::loadStreams(const QVariantList &streams) {
+    foreach (QVariant v, streams) {
+        QVariantMap stream = v.toMap();
+        append(QString("%1p %2").arg(stream.value("height").toInt()).arg(stream.value("description").toString()),
+               stream);
+    }
+}
+
 void YouTubeStreamModel::onRequestFinished() {
-    if (m_request->status() == QYouTube::StreamsRequest::Ready) {
-        foreach (QVariant v, m_request->result().toList()) {
-            QVariantMap stream = v.toMap();
-            append(QString("%1p %2").arg(stream.value("height").toInt()).arg(stream.value("description").toString()),
-                   stream);
-        }
+    m_status = m_request->status();
+    
+    if (m_status == QYouTube::StreamsRequest::Ready) {
+        const QVariantList streams = m_request->result().toList();
+        StreamCache::instance()->insert(Resources::YOUTUBE, m_id, streams);
+        loadStreams(streams);
     }
     
     emit statusChanged(status());
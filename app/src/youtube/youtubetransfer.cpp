@@ -15,6 +15,8 @@
  */
 
 #include "youtubetransfer.h"
+#include "resources.h"
+#include "streamcache.h"
 #include <qyoutube/streamsrequest.h>
 #include <qyoutube/subtitlesrequest.h>
 #if QT_VERSION >= 0x050000
@@ -29,9 +31,17 @@ YouTubeTransfer::YouTubeTransfer(QObject *parent) :
     m_streamsRequest(0),
     m_subtitlesRequest(0)
 {
+    setService(Resources::YOUTUBE);
 }
 
 void YouTubeTransfer::listStreams() {
+    const QVariantMap stream = selectStream(StreamCache::instance()->streams(service(), resourceId()));
+    
+    if (!stream.isEmpty()) {
+        startDownload(stream.value("url").toString());
+        return;
+    }
+    
     if (!m_streamsRequest) {
         m_streamsRequest = new QYouTube::StreamsRequest(this);
         connect(m_streamsRequest, SIGNAL(finished()), this, SLOT(onStreamsRequestFinished()));
@@ -52,14 +62,12 @@ void YouTubeTransfer::listSubtitles() {
 void YouTubeTransfer::onStreamsRequestFinished() {
     if (m_streamsRequest->status() == QYouTube::StreamsRequest::Ready) {
         QVariantList list = m_streamsRequest->result().toList();
+        StreamCache::instance()->insert(service(), resourceId(), list);
+        const QVariantMap stream = selectStream(list);
         
-        foreach (QVariant v, list) {
-            QVariantMap stream = v.toMap();
-        
-            if (stream.value("id") == streamId()) {
-                startDownload(stream.value("url").toString());
-                return;
-            }
+        if (!stream.isEmpty()) {
+            startDownload(stream.value("url").toString());
+            return;
         }
     }
     
@@ -91,10 +99,5 @@ void YouTubeTransfer::onSubtitlesRequestFinished() {
 #ifdef CUTETUBE_DEBUG
     qDebug() << "YouTubeTransfer::onSubtitlesRequestFinished: No subtitles found";
 #endif
-    if (convertToAudio()) {
-        startAudioConversion();
-    }
-    else {
-        moveDownloadedFiles();
-    }
+    finishSubtitlesDownload();
 }
@@ -21,24 +21,28 @@
 #endif
 
 YouTubeUserModel::YouTubeUserModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QYouTube::ResourcesRequest(this)),
     m_contentRequest(0)
 {
-    m_roles[BannerUrlRole] = "bannerUrl";
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeBannerUrlRole] = "largeBannerUrl";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[RelatedPlaylistsRole] = "relatedPlaylists";
-    m_roles[SubscribedRole] = "subscribed";
-    m_roles[SubscriptionIdRole] = "subscriptionId";
-    m_roles[SubscriberCountRole] = "subscriberCount";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[UsernameRole] = "username";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
+    static RoleTable<YouTubeUser> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(BannerUrlRole, "bannerUrl", &YouTubeUser::bannerUrl);
+        roles.insert(DescriptionRole, "description", &CTUser::description);
+        roles.insert(IdRole, "id", &CTUser::id);
+        roles.insert(LargeBannerUrlRole, "largeBannerUrl", &YouTubeUser::largeBannerUrl);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTUser::largeThumbnailUrl);
+        roles.insert(RelatedPlaylistsRole, "relatedPlaylists", &YouTubeUser::relatedPlaylists);
+        roles.insert(SubscribedRole, "subscribed", &YouTubeUser::isSubscribed);
+        roles.insert(SubscriptionIdRole, "subscriptionId", &YouTubeUser::subscriptionId);
+        roles.insert(SubscriberCountRole, "subscriberCount", &YouTubeUser::subscriberCount);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTUser::thumbnailUrl);
+        roles.insert(UsernameRole, "username", &CTUser::username);
+    }
+    
+    setRoleTable(&roles);
+    
     m_request->setApiKey(YouTube::instance()->apiKey());
     m_request->setClientId(YouTube::instance()->clientId());
     m_request->setClientSecret(YouTube::instance()->clientSecret());
@@ -62,12 +66,6 @@ QYouTube::ResourcesRequest::Status YouTubeUserModel::status() const {
     return m_request->status();
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> YouTubeUserModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int YouTubeUserModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -88,49 +86,6 @@ void YouTubeUserModel::fetchMore(const QModelIndex &) {
     emit statusChanged(status());
 }
 
-QVariant YouTubeUserModel::data(const QModelIndex &index, int role) const {
-    if (YouTubeUser *user = get(index.row())) {
-        return user->property(m_roles[role]);
-    }
-    
-    return QVariant();
-}
-
-QMap<int, QVariant> YouTubeUserModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (YouTubeUser *user = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = user->property(iterator.value());
-        }
-    }
-    
-    return map;
-}
-
-QVariant YouTubeUserModel::data(int row, const QByteArray &role) const {
-    if (YouTubeUser *user = get(row)) {
-        return user->property(role);
-    }
-    
-    return QVariant();
-}
-
-QVariantMap YouTubeUserModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (YouTubeUser *user = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = user->property(role);
-        }
-    }
-    
-    return map;
-}
-
 YouTubeUser* YouTubeUserModel::get(int row) const {
     if ((row >= 0) && (row < m_items.size())) {
         return m_items.at(row);
@@ -18,10 +18,10 @@
 #define YOUTUBEUSERMODEL_H
 
 #include "youtubeuser.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
 #include <QStringList>
 
-class YouTubeUserModel : public QAbstractListModel
+class YouTubeUserModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -52,20 +52,11 @@ public:
     
     QYouTube::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
-    QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
-    
     Q_INVOKABLE YouTubeUser* get(int row) const;
     
     Q_INVOKABLE void list(const QString &resourcePath, const QStringList &part,
@@ -108,8 +99,6 @@ private:
     QVariantList m_results;
     
     QList<YouTubeUser*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // YOUTUBEUSERMODEL_H
@@ -22,6 +22,8 @@
 #include <QDebug>
 #endif
 
+VideoRegistry<YouTubeVideo> YouTubeVideo::registry;
+
 YouTubeVideo::YouTubeVideo(QObject *parent) :
     CTVideo(parent),
     m_request(0),
@@ -33,14 +35,8 @@ YouTubeVideo::YouTubeVideo(QObject *parent) :
     m_likeCount(0)
 {
     setService(Resources::YOUTUBE);
-    connect(YouTube::instance(), SIGNAL(videoDisliked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoLiked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoFavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoUnfavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 YouTubeVideo::YouTubeVideo(const QString &id, QObject *parent) :
@@ -55,14 +51,8 @@ YouTubeVideo::YouTubeVideo(const QString &id, QObject *parent) :
 {
     setService(Resources::YOUTUBE);
     loadVideo(id);
-    connect(YouTube::instance(), SIGNAL(videoDisliked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoLiked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoFavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoUnfavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 YouTubeVideo::YouTubeVideo(const QVariantMap &video, QObject *parent) :
@@ -77,14 +67,8 @@ YouTubeVideo::YouTubeVideo(const QVariantMap &video, QObject *parent) :
 {
     setService(Resources::YOUTUBE);
     loadVideo(video);
-    connect(YouTube::instance(), SIGNAL(videoDisliked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoLiked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoFavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoUnfavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
 }
 
 YouTubeVideo::YouTubeVideo(const YouTubeVideo *video, QObject *parent) :
@@ -99,14 +83,12 @@ YouTubeVideo::YouTubeVideo(const YouTubeVideo *video, QObject *parent) :
     m_likeCount(video->likeCount()),
     m_playlistItemId(video->playlistItemId())
 {
-    connect(YouTube::instance(), SIGNAL(videoDisliked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoLiked(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoFavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
-    connect(YouTube::instance(), SIGNAL(videoUnfavourited(YouTubeVideo*)),
-            this, SLOT(onVideoUpdated(YouTubeVideo*)));
+    registry.insert(this);
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+}
+
+YouTubeVideo::~YouTubeVideo() {
+    registry.remove(this);
 }
 
 bool YouTubeVideo::isDisliked() const {
@@ -222,22 +204,16 @@ void YouTubeVideo::loadVideo(const QString &id) {
 
 void YouTubeVideo::loadVideo(const QVariantMap &video) {
     QVariantMap snippet = video.value("snippet").toMap();
-    QVariantMap contentDetails = video.value("contentDetails").toMap();
-    QVariantMap statistics = video.value("statistics").toMap();
     QVariantMap thumbnails = snippet.value("thumbnails").toMap();
     
     setDate(QDateTime::fromString(snippet.value("publishedAt").toString(), Qt::ISODate).toString("dd MMM yyyy"));
     setDescription(snippet.value("description").toString());
-    setDislikeCount(statistics.value("dislikeCount").toLongLong());
-    setDuration(YouTube::formatDuration(contentDetails.value("duration").toString()));
-    setFavouriteCount(statistics.value("favoriteCount").toLongLong());
     setLargeThumbnailUrl(thumbnails.value("high").toMap().value("url").toString());
-    setLikeCount(statistics.value("likeCount").toLongLong());
     setUserId(snippet.value("channelId").toString());
     setUsername(snippet.value("channelTitle").toString());
     setThumbnailUrl(thumbnails.value("default").toMap().value("url").toString());
     setTitle(snippet.value("title").toString());
-    setViewCount(statistics.value("viewCount").toLongLong());
+    loadAdditionalContent(video);
     
     if (video.value("kind") == "youtube#searchResult") {
         setId(video.value("id").toMap().value("videoId").toString());
@@ -257,6 +233,9 @@ void YouTubeVideo::loadVideo(const QVariantMap &video) {
             }
         }
     }
+    else if (video.value("kind") == "youtube#activity") {
+        setId(YouTube::getVideoId(video));
+    }
     else {
         setId(video.value("id").toString());
     }
@@ -264,6 +243,17 @@ void YouTubeVideo::loadVideo(const QVariantMap &video) {
     setUrl("https://www.youtube.com/watch?v=" + id());
 }
 
+void YouTubeVideo::loadAdditionalContent(const QVariantMap &video) {
+    QVariantMap contentDetails = video.value("contentDetails").toMap();
+    QVariantMap statistics = video.value("statistics").toMap();
+    
+    setDislikeCount(statistics.value("dislikeCount").toLongLong());
+    setDuration(YouTube::formatDuration(contentDetails.value("duration").toString()));
+    setFavouriteCount(statistics.value("favoriteCount").toLongLong());
+    setLikeCount(statistics.value("likeCount").toLongLong());
+    setViewCount(statistics.value("viewCount").toLongLong());
+}
+
 void YouTubeVideo::loadVideo(YouTubeVideo *video) {
     CTVideo::loadVideo(video);
     setDisliked(video->isDisliked());
@@ -408,6 +398,7 @@ void YouTubeVideo::onFavouriteRequestFinished() {
         setFavourite(true);
         setFavouriteCount(favouriteCount() + 1);
         setFavouriteId(m_request->result().toMap().value("id").toString());
+        registry.update(this);
         emit YouTube::instance()->videoFavourited(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "YouTubeVideo::onFavouriteRequestFinished OK" << id();
@@ -423,6 +414,7 @@ void YouTubeVideo::onUnfavouriteRequestFinished() {
         setFavourite(false);
         setFavouriteCount(favouriteCount() - 1);
         setFavouriteId(QString());
+        registry.update(this);
         emit YouTube::instance()->videoUnfavourited(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "YouTubeVideo::onUnfavouriteRequestFinished OK" << id();
@@ -438,6 +430,7 @@ void YouTubeVideo::onLikeRequestFinished() {
         setLiked(true);
         setLikeCount(likeCount() + 1);
         setDisliked(false);
+        registry.update(this);
         emit YouTube::instance()->videoLiked(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "YouTubeVideo::onLikeRequestFinished OK" << id();
@@ -453,6 +446,7 @@ void YouTubeVideo::onDislikeRequestFinished() {
         setDisliked(true);
         setDislikeCount(dislikeCount() + 1);
         setLiked(false);
+        registry.update(this);
         emit YouTube::instance()->videoDisliked(this);
 #ifdef CUTETUBE_DEBUG
         qDebug() << "YouTubeVideo::onDislikeRequestFinished OK" << id();
@@ -475,8 +469,6 @@ void YouTubeVideo::onWatchLaterRequestFinished() {
     emit statusChanged(status());
 }
 
-void YouTubeVideo::onVideoUpdated(YouTubeVideo *video) {
-    if ((video->id() == id()) && (video != this)) {
-        loadVideo(video);
-    }
+void YouTubeVideo::onIdChanged() {
+    registry.insert(this);
 }
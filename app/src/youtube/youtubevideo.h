@@ -18,6 +18,7 @@
 #define YOUTUBEVIDEO_H
 
 #include "video.h"
+#include "videoregistry.h"
 #include <qyoutube/resourcesrequest.h>
 
 class YouTubeVideo : public CTVideo
@@ -40,6 +41,7 @@ public:
     explicit YouTubeVideo(const QString &id, QObject *parent = 0);
     explicit YouTubeVideo(const QVariantMap &video, QObject *parent = 0);
     explicit YouTubeVideo(const YouTubeVideo *video, QObject *parent = 0);
+    ~YouTubeVideo();
     
     bool isDisliked() const;
     qint64 dislikeCount() const;
@@ -61,6 +63,8 @@ public:
     Q_INVOKABLE void loadVideo(const QVariantMap &video);
     Q_INVOKABLE void loadVideo(YouTubeVideo *video);
     
+    void loadAdditionalContent(const QVariantMap &video);
+    
 public Q_SLOTS:
     void favourite();
     void unfavourite();
@@ -92,7 +96,7 @@ private Q_SLOTS:
     void onLikeRequestFinished();
     void onDislikeRequestFinished();
     void onWatchLaterRequestFinished();
-    void onVideoUpdated(YouTubeVideo *video);
+    void onIdChanged();
     
 Q_SIGNALS:
     void dislikedChanged();
@@ -106,6 +110,8 @@ Q_SIGNALS:
     void statusChanged(QYouTube::ResourcesRequest::Status s);
 
 private:
+    static VideoRegistry<YouTubeVideo> registry;
+    
     QYouTube::ResourcesRequest *m_request;
     
     bool m_disliked;
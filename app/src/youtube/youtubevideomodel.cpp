@@ -17,45 +17,57 @@
 #include "youtubevideomodel.h"
 #include "youtube.h"
 #include "youtubeplaylist.h"
+#include "resources.h"
+#include "responsecache.h"
+#include "settings.h"
 #ifdef CUTETUBE_DEBUG
 #include <QDebug>
 #endif
 
+static const int MAX_CONTENT_IDS = 50;
+static const int MAX_CONTENT_CACHE_SIZE = 1000;
+
+QCache<QString, QVariantMap> YouTubeVideoModel::contentCache(MAX_CONTENT_CACHE_SIZE);
+
 YouTubeVideoModel::YouTubeVideoModel(QObject *parent) :
-    QAbstractListModel(parent),
+    RoleListModel(parent),
     m_request(new QYouTube::ResourcesRequest(this)),
-    m_contentRequest(0)
+    m_contentRequest(0),
+    m_prefetchRequest(0),
+    m_status(m_request->status()),
+    m_revalidating(false),
+    m_prefetchReady(false),
+    m_prefetchWaiting(false),
+    m_prefetchFailed(false),
+    m_prefetchQueued(false)
 {
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DislikedRole] = "disliked";
-    m_roles[DislikeCountRole] = "dislikeCount";
-    m_roles[DurationRole] = "duration";
-    m_roles[FavouriteRole] = "favourited";
-    m_roles[FavouriteCountRole] = "favouriteCount";
-    m_roles[FavouriteIdRole] = "favouriteId";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[LikedRole] = "liked";
-    m_roles[LikeCountRole] = "likeCount";
-    m_roles[PlaylistItemIdRole] = "playlistItemId";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
-    m_roles[UserIdRole] = "userId";
-    m_roles[UsernameRole] = "username";
-    m_roles[ViewCountRole] = "viewCount";
-#if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
-#endif
-    m_request->setApiKey(YouTube::instance()->apiKey());
-    m_request->setClientId(YouTube::instance()->clientId());
-    m_request->setClientSecret(YouTube::instance()->clientSecret());
-    m_request->setAccessToken(YouTube::instance()->accessToken());
-    m_request->setRefreshToken(YouTube::instance()->refreshToken());
-    
-    connect(m_request, SIGNAL(accessTokenChanged(QString)), YouTube::instance(), SLOT(setAccessToken(QString)));
-    connect(m_request, SIGNAL(refreshTokenChanged(QString)), YouTube::instance(), SLOT(setRefreshToken(QString)));
+    static RoleTable<YouTubeVideo> roles;
+    
+    if (roles.isEmpty()) {
+        roles.insert(DateRole, "date", &CTVideo::date);
+        roles.insert(DescriptionRole, "description", &CTVideo::description);
+        roles.insert(DislikedRole, "disliked", &YouTubeVideo::isDisliked);
+        roles.insert(DislikeCountRole, "dislikeCount", &YouTubeVideo::dislikeCount);
+        roles.insert(DurationRole, "duration", &CTVideo::duration);
+        roles.insert(FavouriteRole, "favourited", &YouTubeVideo::isFavourite);
+        roles.insert(FavouriteCountRole, "favouriteCount", &YouTubeVideo::favouriteCount);
+        roles.insert(FavouriteIdRole, "favouriteId", &YouTubeVideo::favouriteId);
+        roles.insert(IdRole, "id", &CTVideo::id);
+        roles.insert(LargeThumbnailUrlRole, "largeThumbnailUrl", &CTVideo::largeThumbnailUrl);
+        roles.insert(LikedRole, "liked", &YouTubeVideo::isLiked);
+        roles.insert(LikeCountRole, "likeCount", &YouTubeVideo::likeCount);
+        roles.insert(PlaylistItemIdRole, "playlistItemId", &YouTubeVideo::playlistItemId);
+        roles.insert(ThumbnailUrlRole, "thumbnailUrl", &CTVideo::thumbnailUrl);
+        roles.insert(TitleRole, "title", &CTVideo::title);
+        roles.insert(UrlRole, "url", &CTVideo::url);
+        roles.insert(UserIdRole, "userId", &CTVideo::userId);
+        roles.insert(UsernameRole, "username", &CTVideo::username);
+        roles.insert(ViewCountRole, "viewCount", &CTVideo::viewCount);
+    }
+    
+    setRoleTable(&roles);
+    
+    initRequest(m_request);
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
 }
 
@@ -64,19 +76,13 @@ QString YouTubeVideoModel::errorString() const {
 }
 
 QYouTube::ResourcesRequest::Status YouTubeVideoModel::status() const {
-    if ((m_contentRequest) && (m_contentRequest->status() == QYouTube::ResourcesRequest::Loading)) {
+    if ((m_prefetchWaiting) && (isPrefetching())) {
         return QYouTube::ResourcesRequest::Loading;
     }
     
-    return m_request->status();
+    return m_status;
 }
 
-#if QT_VERSION >=0x050000
-QHash<int, QByteArray> YouTubeVideoModel::roleNames() const {
-    return m_roles;
-}
-#endif
-
 int YouTubeVideoModel::rowCount(const QModelIndex &) const {
     return m_items.size();
 }
@@ -90,54 +96,33 @@ void YouTubeVideoModel::fetchMore(const QModelIndex &) {
         return;
     }
     
-    QVariantMap params = m_params;
-    params["pageToken"] = m_nextPageToken;
+    m_prefetchFailed = false;
     
-    m_request->list(m_resourcePath, m_part, m_filters, params);
-    emit statusChanged(status());
-}
-
-QVariant YouTubeVideoModel::data(const QModelIndex &index, int role) const {
-    if (YouTubeVideo *video = get(index.row())) {
-        return video->property(m_roles[role]);
+    if (m_prefetchReady) {
+        loadPrefetchedResults();
+        return;
     }
     
-    return QVariant();
-}
-
-QMap<int, QVariant> YouTubeVideoModel::itemData(const QModelIndex &index) const {
-    QMap<int, QVariant> map;
-    
-    if (YouTubeVideo *video = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = video->property(iterator.value());
-        }
+    if (isPrefetching()) {
+        m_prefetchWaiting = true;
+        emit statusChanged(status());
+        return;
     }
     
-    return map;
-}
-
-QVariant YouTubeVideoModel::data(int row, const QByteArray &role) const {
-    if (YouTubeVideo *video = get(row)) {
-        return video->property(role);
-    }
+    QVariantMap params = m_params;
+    params["pageToken"] = m_nextPageToken;
     
-    return QVariant();
+    m_request->list(m_resourcePath, m_part, m_filters, params);
+    m_status = m_request->status();
+    emit statusChanged(status());
 }
 
-QVariantMap YouTubeVideoModel::itemData(int row) const {
-    QVariantMap map;
-    
-    if (YouTubeVideo *video = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = video->property(role);
-        }
+QVariant YouTubeVideoModel::data(const QModelIndex &index, int role) const {
+    if (get(index.row())) {
+        prefetchIfNeeded(index.row());
     }
     
-    return map;
+    return RoleListModel::data(index, role);
 }
 
 YouTubeVideo* YouTubeVideoModel::get(int row) const {
@@ -160,7 +145,15 @@ void YouTubeVideoModel::list(const QString &resourcePath, const QStringList &par
     m_part = part;
     m_filters = filters;
     m_params = params;
-    m_request->list(resourcePath, part, filters, params);
+    
+    if (loadCachedResult()) {
+        m_status = QYouTube::ResourcesRequest::Ready;
+    }
+    else {
+        m_request->list(resourcePath, part, filters, params);
+        m_status = m_request->status();
+    }
+    
     emit statusChanged(status());
     
     disconnect(YouTube::instance(), 0, this, 0);
@@ -186,6 +179,14 @@ void YouTubeVideoModel::list(const QString &resourcePath, const QStringList &par
 }
 
 void YouTubeVideoModel::clear() {
+    cancelPrefetch();
+    m_prefetchFailed = false;
+    m_contentIds.clear();
+    
+    if (m_contentRequest) {
+        m_contentRequest->cancel();
+    }
+    
     if (!m_items.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
@@ -197,53 +198,234 @@ void YouTubeVideoModel::clear() {
 }
 
 void YouTubeVideoModel::cancel() {
+    cancelPrefetch();
     m_request->cancel();
 }
 
 void YouTubeVideoModel::reload() {
     clear();
+    m_cacheKey = cacheKey();
     m_request->list(m_resourcePath, m_part, m_filters, m_params);
+    m_status = m_request->status();
     emit statusChanged(status());
 }
 
+void YouTubeVideoModel::initRequest(QYouTube::ResourcesRequest *request) {
+    request->setApiKey(YouTube::instance()->apiKey());
+    request->setClientId(YouTube::instance()->clientId());
+    request->setClientSecret(YouTube::instance()->clientSecret());
+    request->setAccessToken(YouTube::instance()->accessToken());
+    request->setRefreshToken(YouTube::instance()->refreshToken());
+    
+    connect(request, SIGNAL(accessTokenChanged(QString)), YouTube::instance(), SLOT(setAccessToken(QString)));
+    connect(request, SIGNAL(refreshTokenChanged(QString)), YouTube::instance(), SLOT(setRefreshToken(QString)));
+}
+
+QVariantList YouTubeVideoModel::filterResults(const QVariantMap &result) {
+    QVariantList results = result.value("items").toList();
+    
+    if (result.value("kind") == "youtube#activityListResponse") {
+        foreach (QVariant item, results) {
+            if (item.toMap().value("snippet").toMap().value("type") != "upload") {
+                results.removeOne(item);
+            }
+        }
+    }
+    
+    return results;
+}
+
+void YouTubeVideoModel::cacheAdditionalContent(const QString &id, const QVariantMap &video) {
+    QVariantMap *content = new QVariantMap;
+    content->insert("contentDetails", video.value("contentDetails"));
+    content->insert("statistics", video.value("statistics"));
+    contentCache.insert(id, content);
+}
+
+void YouTubeVideoModel::queueAdditionalContent(const QVariantList &results) {
+    foreach (QVariant result, results) {
+        const QVariantMap video = result.toMap();
+        const QString id = YouTube::getVideoId(video);
+        
+        if (id.isEmpty()) {
+            continue;
+        }
+        
+        if (video.value("kind") == "youtube#video") {
+            cacheAdditionalContent(id, video);
+        }
+        else if ((!contentCache.contains(id)) && (!m_contentIds.contains(id))) {
+            m_contentIds << id;
+        }
+    }
+    
+    getAdditionalContent();
+}
+
 void YouTubeVideoModel::getAdditionalContent() {
+    if ((m_contentIds.isEmpty())
+        || ((m_contentRequest) && (m_contentRequest->status() == QYouTube::ResourcesRequest::Loading))) {
+        return;
+    }
+    
     if (!m_contentRequest) {
         m_contentRequest = new QYouTube::ResourcesRequest(this);
-        m_contentRequest->setApiKey(YouTube::instance()->apiKey());
-        m_contentRequest->setClientId(YouTube::instance()->clientId());
-        m_contentRequest->setClientSecret(YouTube::instance()->clientSecret());
-        m_contentRequest->setAccessToken(YouTube::instance()->accessToken());
-        m_contentRequest->setRefreshToken(YouTube::instance()->refreshToken());
-
-        connect(m_contentRequest, SIGNAL(accessTokenChanged(QString)),
-                YouTube::instance(), SLOT(setAccessToken(QString)));
-        connect(m_contentRequest, SIGNAL(refreshTokenChanged(QString)),
-                YouTube::instance(), SLOT(setRefreshToken(QString)));
+        initRequest(m_contentRequest);
         connect(m_contentRequest, SIGNAL(finished()), this, SLOT(onContentRequestFinished()));
     }
     
-    QStringList ids;
-    
-    foreach (QVariant result, m_results) {
-        ids << YouTube::getVideoId(result.toMap());
-    }
+    const QStringList ids = m_contentIds.mid(0, MAX_CONTENT_IDS);
+    m_contentIds = m_contentIds.mid(ids.size());
     
     QVariantMap filters;
     filters["id"] = ids.join(",");
     
     m_contentRequest->list("/videos", QStringList() << "contentDetails" << "statistics", filters);
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "YouTubeVideoModel::getAdditionalContent" << ids.size() << "ids," << m_contentIds.size() << "queued";
+#endif
+}
+
+bool YouTubeVideoModel::isPrefetching() const {
+    return (m_prefetchRequest) && (m_prefetchRequest->status() == QYouTube::ResourcesRequest::Loading);
 }
 
-void YouTubeVideoModel::loadResults() {
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + m_results.size() - 1);
+void YouTubeVideoModel::prefetchIfNeeded(int row) const {
+    if ((m_prefetchReady) || (m_prefetchFailed) || (m_prefetchQueued) || (m_nextPageToken.isEmpty()) || (isPrefetching())) {
+        return;
+    }
+    
+    const int threshold = Settings::instance()->prefetchThreshold();
     
-    foreach (QVariant result, m_results) {
-        m_items << new YouTubeVideo(result.toMap(), this);
+    if ((threshold > 0) && (row >= m_items.size() - threshold)) {
+        m_prefetchQueued = true;
+        QMetaObject::invokeMethod(const_cast<YouTubeVideoModel*>(this), "prefetch", Qt::QueuedConnection);
+    }
+}
+
+void YouTubeVideoModel::prefetch() {
+    m_prefetchQueued = false;
+    
+    if ((m_prefetchReady) || (m_nextPageToken.isEmpty()) || (isPrefetching())
+        || (status() == QYouTube::ResourcesRequest::Loading)) {
+        return;
+    }
+    
+    if (!m_prefetchRequest) {
+        m_prefetchRequest = new QYouTube::ResourcesRequest(this);
+        initRequest(m_prefetchRequest);
+        connect(m_prefetchRequest, SIGNAL(finished()), this, SLOT(onPrefetchRequestFinished()));
+    }
+    
+    QVariantMap params = m_params;
+    params["pageToken"] = m_nextPageToken;
+    
+    m_prefetchRequest->list(m_resourcePath, m_part, m_filters, params);
+#ifdef CUTETUBE_DEBUG
+    qDebug() << "YouTubeVideoModel::prefetch" << m_resourcePath << m_nextPageToken;
+#endif
+}
+
+void YouTubeVideoModel::cancelPrefetch() {
+    m_prefetchWaiting = false;
+    m_prefetchReady = false;
+    m_prefetchResults.clear();
+    m_prefetchPageToken = QString();
+    
+    if (m_prefetchRequest) {
+        m_prefetchRequest->cancel();
+    }
+}
+
+void YouTubeVideoModel::loadPrefetchedResults() {
+    const QVariantList results = m_prefetchResults;
+    m_nextPageToken = m_prefetchPageToken;
+    m_prefetchResults.clear();
+    m_prefetchPageToken = QString();
+    m_prefetchReady = false;
+    m_prefetchWaiting = false;
+    
+    if (!results.isEmpty()) {
+        loadResults(results);
+    }
+    
+    emit statusChanged(status());
+}
+
+QString YouTubeVideoModel::cacheKey() const {
+    return ResponseCache::cacheKey(Resources::YOUTUBE, m_resourcePath, m_filters, m_params, YouTube::instance()->userId());
+}
+
+bool YouTubeVideoModel::loadCachedResult() {
+    bool stale = false;
+    m_cacheKey = cacheKey();
+    const QVariantMap result = ResponseCache::instance()->result(m_cacheKey, &stale).toMap();
+    
+    if (result.isEmpty()) {
+        return false;
+    }
+    
+    loadResult(result);
+    
+    if (stale) {
+        m_revalidating = true;
+        return false;
+    }
+    
+    m_cacheKey = QString();
+    return true;
+}
+
+void YouTubeVideoModel::loadResult(const QVariantMap &result) {
+    m_nextPageToken = result.value("nextPageToken").toString();
+    const QVariantList results = filterResults(result);
+
+    if (!results.isEmpty()) {
+        loadResults(results);
+        queueAdditionalContent(results);
+    }
+}
+
+void YouTubeVideoModel::loadResults(const QVariantList &results) {
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + results.size() - 1);
+    
+    foreach (QVariant result, results) {
+        YouTubeVideo *video = new YouTubeVideo(result.toMap(), this);
+        
+        if (const QVariantMap *content = contentCache.object(video->id())) {
+            video->loadAdditionalContent(*content);
+        }
+        
+        m_items << video;
     }
 
     endInsertRows();
     emit countChanged(rowCount());
-    emit statusChanged(status());
+}
+
+void YouTubeVideoModel::updateAdditionalContent(const QStringList &ids) {
+    int first = -1;
+    
+    for (int i = 0; i < m_items.size(); i++) {
+        YouTubeVideo *video = m_items.at(i);
+        const QVariantMap *content = ids.contains(video->id()) ? contentCache.object(video->id()) : 0;
+        
+        if (content) {
+            video->loadAdditionalContent(*content);
+            
+            if (first == -1) {
+                first = i;
+            }
+        }
+        else if (first != -1) {
+            emit dataChanged(index(first), index(i - 1));
+            first = -1;
+        }
+    }
+    
+    if (first != -1) {
+        emit dataChanged(index(first), index(m_items.size() - 1));
+    }
 }
 
 void YouTubeVideoModel::append(YouTubeVideo *video) {
@@ -276,56 +458,85 @@ void YouTubeVideoModel::onRequestFinished() {
         QVariantMap result = m_request->result().toMap();
         
         if (!result.isEmpty()) {
-            m_nextPageToken = result.value("nextPageToken").toString();
-            m_results = result.value("items").toList();
-
-            if (!m_results.isEmpty()) {
-                if (result.value("kind") != "youtube#videoListResponse") {
-                    if (result.value("kind") == "youtube#activityListResponse") {
-                        foreach (QVariant item, m_results) {
-                            if (item.toMap().value("snippet").toMap().value("type") != "upload") {
-                                m_results.removeOne(item);
-                            }
-                        }
-                    }
-                    
-                    getAdditionalContent();
-                }
-                else {
-                    loadResults();
+            const bool changed = (!m_revalidating) || (result != ResponseCache::instance()->result(m_cacheKey).toMap());
+            
+            if (!m_cacheKey.isEmpty()) {
+                ResponseCache::instance()->insert(m_cacheKey, result,
+                                                  ResponseCache::timeToLive(m_resourcePath, m_filters));
+            }
+            
+            if (changed) {
+                if (m_revalidating) {
+                    clear();
                 }
-
-                return;
+                
+                loadResult(result);
             }
         }
     }
-
+    
+    // A failed revalidation keeps showing the cached page
+    m_status = m_revalidating ? QYouTube::ResourcesRequest::Ready : m_request->status();
+    m_cacheKey = QString();
+    m_revalidating = false;
     emit statusChanged(status());
 }
 
 void YouTubeVideoModel::onContentRequestFinished() {
+    if (m_contentRequest->status() == QYouTube::ResourcesRequest::Canceled) {
+        return;
+    }
+    
     if (m_contentRequest->status() == QYouTube::ResourcesRequest::Ready) {
-        QVariantMap result = m_contentRequest->result().toMap();
+        QStringList ids;
+        
+        foreach (QVariant item, m_contentRequest->result().toMap().value("items").toList()) {
+            const QVariantMap video = item.toMap();
+            const QString id = video.value("id").toString();
+            cacheAdditionalContent(id, video);
+            ids << id;
+        }
+        
+        updateAdditionalContent(ids);
+    }
+    
+    getAdditionalContent();
+}
+
+void YouTubeVideoModel::onPrefetchRequestFinished() {
+    m_prefetchFailed = (m_prefetchRequest->status() == QYouTube::ResourcesRequest::Failed);
+    
+    if (m_prefetchRequest->status() == QYouTube::ResourcesRequest::Ready) {
+        QVariantMap result = m_prefetchRequest->result().toMap();
         
         if (!result.isEmpty()) {
-            QVariantList list = result.value("items").toList();
-            const int count = qMin(list.size(), m_results.size());
-            
-            for (int i = 0; i < count; i++) {
-                QVariantMap item = list.at(i).toMap();
-                QVariantMap video = m_results.takeAt(i).toMap();
-                video["contentDetails"] = item.value("contentDetails");
-                video["statistics"] = item.value("statistics");
-                m_results.insert(i, video);
-            }
+            m_prefetchPageToken = result.value("nextPageToken").toString();
+            m_prefetchResults = filterResults(result);
+            m_prefetchReady = true;
+            queueAdditionalContent(m_prefetchResults);
         }
     }
+    
+    finishPrefetch();
+}
 
-    loadResults();
+void YouTubeVideoModel::finishPrefetch() {
+    if (m_prefetchWaiting) {
+        m_prefetchWaiting = false;
+        
+        if (m_prefetchReady) {
+            loadPrefetchedResults();
+        }
+        else {
+            fetchMore();
+        }
+    }
 }
 
 void YouTubeVideoModel::onVideoAddedToPlaylist(YouTubeVideo *video, YouTubePlaylist *playlist) {
     if (m_filters.value("playlistId") == playlist->id()) {
+        ResponseCache::instance()->remove(cacheKey());
+        
         insert(0, new YouTubeVideo(video, this));
     }
 #ifdef CUTETUBE_DEBUG
@@ -335,6 +546,8 @@ void YouTubeVideoModel::onVideoAddedToPlaylist(YouTubeVideo *video, YouTubePlayl
 
 void YouTubeVideoModel::onVideoRemovedFromPlaylist(YouTubeVideo *video, YouTubePlaylist *playlist) {
     if (m_filters.value("playlistId") == playlist->id()) {
+        ResponseCache::instance()->remove(cacheKey());
+        
         QModelIndexList list = match(index(0), IdRole, video->id(), 1, Qt::MatchExactly);
         
         if (!list.isEmpty()) {
@@ -347,6 +560,8 @@ void YouTubeVideoModel::onVideoRemovedFromPlaylist(YouTubeVideo *video, YouTubeP
 }
 
 void YouTubeVideoModel::onVideoFavourited(YouTubeVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     insert(0, new YouTubeVideo(video, this));
 #ifdef CUTETUBE_DEBUG
     qDebug() << "YouTubeVideoModel::onVideoFavourited" << video->id();
@@ -354,6 +569,8 @@ void YouTubeVideoModel::onVideoFavourited(YouTubeVideo *video) {
 }
 
 void YouTubeVideoModel::onVideoUnfavourited(YouTubeVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     QModelIndexList list = match(index(0), IdRole, video->id(), 1, Qt::MatchExactly);
     
     if (!list.isEmpty()) {
@@ -365,6 +582,8 @@ void YouTubeVideoModel::onVideoUnfavourited(YouTubeVideo *video) {
 }
 
 void YouTubeVideoModel::onVideoWatchLater(YouTubeVideo *video) {
+    ResponseCache::instance()->remove(cacheKey());
+    
     insert(0, new YouTubeVideo(video, this));
 #ifdef CUTETUBE_DEBUG
     qDebug() << "YouTubeVideoModel::onVideoWatchLater" << video->id();
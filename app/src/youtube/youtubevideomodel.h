@@ -18,12 +18,13 @@
 #define YOUTUBEVIDEOMODEL_H
 
 #include "youtubevideo.h"
-#include <QAbstractListModel>
+#include "rolelistmodel.h"
+#include <QCache>
 #include <QStringList>
 
 class YouTubePlaylist;
 
-class YouTubeVideoModel : public QAbstractListModel
+class YouTubeVideoModel : public RoleListModel
 {
     Q_OBJECT
     
@@ -61,19 +62,13 @@ public:
     
     QYouTube::ResourcesRequest::Status status() const;
     
-#if QT_VERSION >= 0x050000
-    QHash<int, QByteArray> roleNames() const;
-#endif
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
     Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
     
+    using RoleListModel::data;
     QVariant data(const QModelIndex &index, int role) const;
-    QMap<int, QVariant> itemData(const QModelIndex &index) const;
-    
-    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
-    Q_INVOKABLE QVariantMap itemData(int row) const;
     
     Q_INVOKABLE YouTubeVideo* get(int row) const;
     
@@ -86,8 +81,23 @@ public Q_SLOTS:
     void reload();
     
 private:
+    void initRequest(QYouTube::ResourcesRequest *request);
+    
+    static QVariantList filterResults(const QVariantMap &result);
+    static void cacheAdditionalContent(const QString &id, const QVariantMap &video);
+    void queueAdditionalContent(const QVariantList &results);
     void getAdditionalContent();
-    void loadResults();
+    void updateAdditionalContent(const QStringList &ids);
+    QString cacheKey() const;
+    bool loadCachedResult();
+    void loadResult(const QVariantMap &result);
+    void loadResults(const QVariantList &results);
+    
+    bool isPrefetching() const;
+    void prefetchIfNeeded(int row) const;
+    void cancelPrefetch();
+    void loadPrefetchedResults();
+    void finishPrefetch();
     
     void append(YouTubeVideo *video);
     void insert(int row, YouTubeVideo *video);
@@ -96,6 +106,8 @@ private:
 private Q_SLOTS:
     void onRequestFinished();
     void onContentRequestFinished();
+    void prefetch();
+    void onPrefetchRequestFinished();
     void onVideoAddedToPlaylist(YouTubeVideo *video, YouTubePlaylist *playlist);
     void onVideoRemovedFromPlaylist(YouTubeVideo *video, YouTubePlaylist *playlist);
     void onVideoFavourited(YouTubeVideo *video);
@@ -109,6 +121,9 @@ Q_SIGNALS:
 private:
     QYouTube::ResourcesRequest *m_request;
     QYouTube::ResourcesRequest *m_contentRequest;
+    QYouTube::ResourcesRequest *m_prefetchRequest;
+    
+    QYouTube::ResourcesRequest::Status m_status;
     
     QString m_resourcePath;
     QStringList m_part;
@@ -116,11 +131,21 @@ private:
     QVariantMap m_params;
     QString m_nextPageToken;
     
-    QVariantList m_results;
+    QString m_cacheKey;
+    bool m_revalidating;
+    
+    QStringList m_contentIds;
+    
+    QVariantList m_prefetchResults;
+    QString m_prefetchPageToken;
+    bool m_prefetchReady;
+    bool m_prefetchWaiting;
+    bool m_prefetchFailed;
+    mutable bool m_prefetchQueued;
     
     QList<YouTubeVideo*> m_items;
     
-    QHash<int, QByteArray> m_roles;
+    static QCache<QString, QVariantMap> contentCache;
 };
     
 #endif // YOUTUBEVIDEOMODEL_H
@@ -1,6 +1,6 @@
 TEMPLATE = app
 TARGET = cutetube2-rss
-QT += network xml
+QT += network
 QT -= gui
 
 HEADERS += \
@@ -17,61 +17,285 @@
 #include "rss.h"
 #include "json.h"
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
-#include <QDomDocument>
-#include <QDomElement>
-#include <QDomNodeList>
-#include <QDateTime>
+#include <QSettings>
 #include <stdio.h>
 
 static const int MAX_REDIRECTS = 8;
-
-bool dateGreaterThan(QVariant &one, QVariant &two) {
-    return one.toMap().value("_dt").toDateTime() > two.toMap().value("_dt").toDateTime();
-}
+static const int MAX_CONNECTIONS_PER_HOST = 2;
+static const quint32 STATE_VERSION = 1;
 
 Rss::Rss(QObject *parent) :
     QObject(parent),
     m_nam(new QNetworkAccessManager(this)),
-    m_redirects(0)
+    m_statePath(QFileInfo(QSettings("cuteTube2", "cuteTube2").fileName()).absolutePath() + "/rss/")
 {
-    connect(m_nam, SIGNAL(finished(QNetworkReply*)), this, SLOT(parseVideos(QNetworkReply*)));
+}
+
+Rss::~Rss() {
+    qDeleteAll(m_feeds);
+}
+
+bool Rss::itemGreaterThan(const Item &one, const Item &two) {
+    return one.key > two.key;
 }
 
 void Rss::listVideos(const QStringList &urls) {
-    m_urls = urls;
-    
-    if (m_urls.isEmpty()) {
-        printf(qPrintable(QString("{\"error\": \"%1\"}").arg(tr("No feed URLs specified"))));
-        QCoreApplication::exit(1);
+    if (urls.isEmpty()) {
+        error(tr("No feed URLs specified"));
         return;
     }
     
-    listVideos(m_urls.takeFirst());
+    foreach (const QString &url, urls) {
+        Feed *feed = new Feed;
+        feed->source = url;
+        feed->url = url;
+        feed->redirects = 0;
+        loadState(feed);
+        m_feeds << feed;
+        m_queue << feed;
+    }
+    
+    startNext();
 }
 
 void Rss::listVideos(const QString &url) {    
-    m_redirects = 0;
-    m_nam->get(QNetworkRequest(url));
+    listVideos(QStringList() << url);
+}
+
+QString Rss::stateFileName(const Feed *feed) const {
+    return m_statePath
+           + QString::fromLatin1(QCryptographicHash::hash(feed->source.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+void Rss::loadState(Feed *feed) {
+    QFile file(stateFileName(feed));
+    
+    if (!file.open(QFile::ReadOnly)) {
+        return;
+    }
+    
+    QDataStream stream(&file);
+    quint32 version;
+    stream >> version;
+    
+    if (version != STATE_VERSION) {
+        return;
+    }
+    
+    QByteArray etag;
+    QByteArray lastModified;
+    QList<Item> items;
+    int count;
+    stream >> etag >> lastModified >> count;
+    
+    for (int i = 0; (i < count) && (stream.status() == QDataStream::Ok); i++) {
+        Item item;
+        stream >> item.key >> item.result;
+        items << item;
+    }
+    
+    if (stream.status() == QDataStream::Ok) {
+        feed->etag = etag;
+        feed->lastModified = lastModified;
+        feed->cachedItems = items;
+    }
+}
+
+void Rss::saveState(const Feed *feed, const QNetworkReply *reply) {
+    const QByteArray etag = reply->rawHeader("ETag");
+    const QByteArray lastModified = reply->rawHeader("Last-Modified");
+    const QString fileName = stateFileName(feed);
+    
+    if ((etag.isEmpty()) && (lastModified.isEmpty())) {
+        QFile::remove(fileName);
+        return;
+    }
+    
+    QDir().mkpath(m_statePath);
+    QFile file(fileName);
+    
+    if (!file.open(QFile::WriteOnly)) {
+        return;
+    }
+    
+    QDataStream stream(&file);
+    stream << STATE_VERSION << etag << lastModified << feed->items.size();
+    
+    foreach (const Item &item, feed->items) {
+        stream << item.key << item.result;
+    }
+}
+
+void Rss::startNext() {
+    int i = 0;
+    
+    while (i < m_queue.size()) {
+        Feed *feed = m_queue.at(i);
+        const QString host = feed->url.host();
+        
+        if (m_hosts.value(host) >= MAX_CONNECTIONS_PER_HOST) {
+            i++;
+            continue;
+        }
+        
+        m_queue.removeAt(i);
+        m_hosts[host]++;
+        feed->reader.clear();
+        feed->items.clear();
+        feed->current.clear();
+        feed->text.clear();
+        feed->depth = 0;
+        feed->itemDepth = -1;
+        
+        QNetworkRequest request(feed->url);
+        
+        if (!feed->cachedItems.isEmpty()) {
+            if (!feed->etag.isEmpty()) {
+                request.setRawHeader("If-None-Match", feed->etag);
+            }
+            
+            if (!feed->lastModified.isEmpty()) {
+                request.setRawHeader("If-Modified-Since", feed->lastModified);
+            }
+        }
+        
+        QNetworkReply *reply = m_nam->get(request);
+        m_replies.insert(reply, feed);
+        connect(reply, SIGNAL(readyRead()), this, SLOT(onReplyReadyRead()));
+        connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+    }
 }
 
-void Rss::followRedirect(const QUrl &url) {
-    m_redirects++;
-    m_nam->get(QNetworkRequest(url));
+bool Rss::parseFeed(Feed *feed, const QByteArray &data) {
+    QXmlStreamReader &reader = feed->reader;
+    reader.addData(data);
+    
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            feed->depth++;
+            feed->text.clear();
+            
+            if (reader.name() == "item") {
+                feed->itemDepth = feed->depth;
+                feed->current.clear();
+            }
+            else if (feed->itemDepth == -1) {
+                if ((reader.name() == "image") && (feed->thumbnailUrl.isEmpty())) {
+                    feed->thumbnailUrl = reader.attributes().value("href").toString();
+                }
+            }
+            else if ((feed->depth == feed->itemDepth + 1) && (reader.name() == "enclosure")
+                     && (!feed->current.contains("enclosure"))) {
+                feed->current["enclosure"] = reader.attributes().value("url").toString();
+            }
+            
+            break;
+        case QXmlStreamReader::Characters:
+            if (feed->itemDepth != -1) {
+                feed->text += reader.text().toString();
+            }
+            
+            break;
+        case QXmlStreamReader::EndElement:
+            if (feed->depth == feed->itemDepth) {
+                const QDateTime dt = QDateTime::fromString(feed->current.value("pubDate").toString()
+                                                           .section(' ', 0, -2), "ddd, dd MMM yyyy hh:mm:ss");
+                Item item;
+                item.key = dt.isValid() ? dt.toMSecsSinceEpoch() : 0;
+                item.result["date"] = dt.toString("dd MMM yyyy");
+                item.result["description"] = feed->current.value("description");
+                item.result["duration"] = feed->current.value("duration");
+                item.result["id"] = feed->url;
+                item.result["streamUrl"] = feed->current.value("enclosure");
+                item.result["title"] = feed->current.value("title");
+                item.result["url"] = feed->current.value("link");
+                item.result["username"] = feed->current.value("author");
+                feed->items << item;
+                feed->itemDepth = -1;
+            }
+            else if ((feed->itemDepth != -1) && (feed->depth == feed->itemDepth + 1)) {
+                const QString name = reader.name().toString();
+                
+                if (!feed->current.contains(name)) {
+                    feed->current[name] = feed->text;
+                }
+            }
+            
+            feed->depth--;
+            break;
+        default:
+            break;
+        }
+    }
+    
+    return (!reader.hasError()) || (reader.error() == QXmlStreamReader::PrematureEndOfDocumentError);
 }
 
-void Rss::parseVideos(QNetworkReply *reply) {
+void Rss::finishFeed(Feed *feed) {
+    for (int i = 0; i < feed->items.size(); i++) {
+        QVariantMap &result = feed->items[i].result;
+        result["largeThumbnailUrl"] = feed->thumbnailUrl;
+        result["thumbnailUrl"] = feed->thumbnailUrl;
+    }
+    
+    qStableSort(feed->items.begin(), feed->items.end(), itemGreaterThan);
+}
+
+void Rss::error(const QString &message) {
+    printf(qPrintable(QString("{\"error\": \"%1\"}").arg(message)));
+    QCoreApplication::exit(1);
+}
+
+void Rss::onReplyReadyRead() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    
+    if ((!reply) || (!m_replies.contains(reply))) {
+        return;
+    }
+    
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    
+    // Only successful bodies are feeds. Redirects, 304s and error pages are handled in onReplyFinished()
+    if ((status < 200) || (status >= 300)) {
+        return;
+    }
+    
+    if (!parseFeed(m_replies.value(reply), reply->readAll())) {
+        m_replies.remove(reply);
+        reply->abort();
+        reply->deleteLater();
+        error(tr("Unable to parse XML"));
+    }
+}
+
+void Rss::onReplyFinished() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    
     if (!reply) {
-        printf(qPrintable(QString("{\"error\": \"%1\"}").arg(tr("Network error"))));
-        QCoreApplication::exit(1);
+        error(tr("Network error"));
         return;
     }
     
+    Feed *feed = m_replies.take(reply);
+    
+    if (!feed) {
+        return;
+    }
+    
+    m_hosts[reply->request().url().host()]--;
+    
     if (reply->error() != QNetworkReply::NoError) {
         reply->deleteLater();
-        printf(qPrintable(QString("{\"error\": \"%1: %2\"}").arg(tr("Network error")).arg(reply->errorString())));
-        QCoreApplication::exit(1);
+        error(QString("%1: %2").arg(tr("Network error")).arg(reply->errorString()));
         return;
     }
     
@@ -80,65 +304,71 @@ void Rss::parseVideos(QNetworkReply *reply) {
     if (!redirect.isNull()) {
         reply->deleteLater();
         
-        if (m_redirects < MAX_REDIRECTS) {
-            followRedirect(redirect.toString());
+        if (feed->redirects < MAX_REDIRECTS) {
+            feed->redirects++;
+            feed->url = reply->url().resolved(redirect.toUrl());
+            m_queue.prepend(feed);
+            startNext();
         }
         else {
-            printf(qPrintable(QString("{\"error\": \"%1: %2\"}").arg(tr("Network error"))
-                                                                .arg(tr("Maximum redirects reached"))));
-            QCoreApplication::exit(1);
+            error(QString("%1: %2").arg(tr("Network error")).arg(tr("Maximum redirects reached")));
         }
         
         return;
     }
     
-    QDomDocument doc;    
-    
-    if (!doc.setContent(reply->readAll(), true)) {
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        feed->items = feed->cachedItems;
+    }
+    else if ((!parseFeed(feed, reply->readAll())) || (feed->reader.hasError())) {
         reply->deleteLater();
-        printf(qPrintable(QString("{\"error\": \"%1\"}").arg(tr("Unable to parse XML"))));
-        QCoreApplication::exit(1);
+        error(tr("Unable to parse XML"));
         return;
     }
-    
-    QDomElement docElem = doc.documentElement();
-    QDomNodeList items = docElem.elementsByTagName("item");
-    QString thumbnailUrl =  docElem.firstChildElement("channel").firstChildElement("image").attribute("href");
-    
-    for (int i = 0; i < items.size(); i++) {
-        QDomElement item = items.at(i).toElement();
-        QDateTime dt = QDateTime::fromString(item.firstChildElement("pubDate").text().section(' ', 0, -2),
-                                               "ddd, dd MMM yyyy hh:mm:ss");
-        QVariantMap result;
-        result["_dt"] = dt;
-        result["date"] = dt.toString("dd MMM yyyy");
-        result["description"] = item.firstChildElement("description").text();
-        result["duration"] = item.firstChildElement("duration").text();
-        result["id"] = reply->url();
-        result["largeThumbnailUrl"] = thumbnailUrl;
-        result["streamUrl"] = item.firstChildElement("enclosure").attribute("url");
-        result["thumbnailUrl"] = thumbnailUrl;
-        result["title"] = item.firstChildElement("title").text();
-        result["url"] = item.firstChildElement("link").text();
-        result["username"] = item.firstChildElement("author").text();
-        m_results << result;
+    else {
+        finishFeed(feed);
+        saveState(feed, reply);
     }
     
     reply->deleteLater();
     
-    if (m_urls.isEmpty()) {
+    if ((m_replies.isEmpty()) && (m_queue.isEmpty())) {
         printResult();
     }
     else {
-        listVideos(m_urls.takeFirst());
+        startNext();
     }
 }
 
 void Rss::printResult() {
-    if (!m_results.isEmpty()) {
-        qSort(m_results.begin(), m_results.end(), dateGreaterThan);
+    QVariantList results;
+    QList<int> positions;
+    
+    for (int i = 0; i < m_feeds.size(); i++) {
+        positions << 0;
+    }
+    
+    forever {
+        int next = -1;
+        
+        for (int i = 0; i < m_feeds.size(); i++) {
+            const QList<Item> &items = m_feeds.at(i)->items;
+            
+            if ((positions.at(i) < items.size())
+                && ((next == -1)
+                    || (items.at(positions.at(i)).key > m_feeds.at(next)->items.at(positions.at(next)).key))) {
+                next = i;
+            }
+        }
+        
+        if (next == -1) {
+            break;
+        }
+        
+        results << m_feeds.at(next)->items.at(positions.at(next)).result;
+        positions[next]++;
     }
     
-    printf(QByteArray("{\"items\": " + QtJson::Json::serialize(m_results) + "}").constData());
+    printf(QByteArray("{\"items\": " + QtJson::Json::serialize(results) + "}").constData());
     QCoreApplication::quit();
 }
@@ -18,12 +18,14 @@
 #define RSS_H
 
 #include <QObject>
+#include <QHash>
 #include <QStringList>
+#include <QUrl>
 #include <QVariantList>
+#include <QXmlStreamReader>
 
 class QNetworkAccessManager;
 class QNetworkReply;
-class QUrl;
 
 class Rss : public QObject
 {
@@ -31,23 +33,59 @@ class Rss : public QObject
 
 public:
     explicit Rss(QObject *parent = 0);
+    ~Rss();
     
     void listVideos(const QStringList &urls);    
     void listVideos(const QString &url);
     
 private:
-    void followRedirect(const QUrl &url);
+    struct Item {
+        qint64 key;
+        QVariantMap result;
+    };
+    
+    struct Feed {
+        QString source;
+        QUrl url;
+        QXmlStreamReader reader;
+        QList<Item> items;
+        QList<Item> cachedItems;
+        QByteArray etag;
+        QByteArray lastModified;
+        QVariantMap current;
+        QString text;
+        QString thumbnailUrl;
+        int depth;
+        int itemDepth;
+        int redirects;
+    };
+    
+    static bool itemGreaterThan(const Item &one, const Item &two);
+    
+    QString stateFileName(const Feed *feed) const;
+    void loadState(Feed *feed);
+    void saveState(const Feed *feed, const QNetworkReply *reply);
+    
+    void startNext();
+    bool parseFeed(Feed *feed, const QByteArray &data);
+    void finishFeed(Feed *feed);
+    
+    void error(const QString &message);
     
 private Q_SLOTS:
-    void parseVideos(QNetworkReply *reply);
+    void onReplyReadyRead();
+    void onReplyFinished();
     void printResult();
     
 private:
     QNetworkAccessManager *m_nam;
     
-    QStringList m_urls;
-    QVariantList m_results;
-    int m_redirects;
+    QString m_statePath;
+    
+    QList<Feed*> m_feeds;
+    QList<Feed*> m_queue;
+    QHash<QNetworkReply*, Feed*> m_replies;
+    QHash<QString, int> m_hosts;
 };
     
 #endif // RSS_H
@@ -212,24 +212,56 @@ def list_items(resource, id):
     
     return []
         
-def search_items(resoruce, query, order):
+def search_items(resource, query, order):
     if not resource or resource == 'video':
         return search_videos(query, order)
     
     return []
         
-def main(method, resource, id, query, order):
+def do_request(method, resource, id, query, order):
     if method == 'list':
-        print json.dumps(list_items(resource, id))
+        return list_items(resource, id)
     elif method == 'get':
-        print json.dumps(get_item(resource, id))
+        return get_item(resource, id)
     elif method == 'search':
-        print json.dumps(search_items(resource, query, order))
+        return search_items(resource, query, order)
     else:
         raise ResourceError('{"error": "Invalid method specified: %s"}' % method)
 
+def main(method, resource, id, query, order):
+    print json.dumps(do_request(method, resource, id, query, order))
+
+def worker():
+    while True:
+        line = sys.stdin.readline()
+        
+        if not line:
+            break
+        
+        if not line.strip():
+            continue
+        
+        response = {}
+        
+        try:
+            request = json.loads(line)
+            response['requestId'] = request.get('requestId', 0)
+            response['result'] = do_request(request.get('method', 'list'), request.get('resource', 'video'),
+                                            request.get('id', ''), request.get('query', ''),
+                                            request.get('order', ''))
+        except ResourceError, e:
+            try:
+                response['error'] = json.loads(e.args[0])['error']
+            except:
+                response['error'] = e.args[0]
+        except Exception, e:
+            response['error'] = str(e)
+        
+        sys.stdout.write(json.dumps(response) + '\n')
+        sys.stdout.flush()
+
 if __name__ == '__main__':
-    (opts, args) = getopt.getopt(sys.argv[1:], 'm:r:i:q:o:')
+    (opts, args) = getopt.getopt(sys.argv[1:], 'm:r:i:q:o:w')
     
     method = 'list'
     resource = 'video'
@@ -248,6 +280,9 @@ if __name__ == '__main__':
             query = a
         elif o == '-o':
             order = a
+        elif o == '-w':
+            worker()
+            exit(0)
     
     try:
         main(method, resource, id, query, order)
@@ -0,0 +1,19 @@
+TEMPLATE = app
+TARGET = jsonparser-benchmark
+
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += DATA_PATH=\\\"$$PWD/data/\\\"
+
+INCLUDEPATH += ../../app/src/base
+
+HEADERS += \
+    ../../app/src/base/json.h \
+    ../../app/src/base/jsonparser.h
+
+SOURCES += \
+    ../../app/src/base/json.cpp \
+    ../../app/src/base/jsonparser.cpp \
+    main.cpp
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json.h"
+#include "jsonparser.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTextStream>
+
+// Plugin output arrives through QProcess in reads of about this size
+static const int CHUNK_SIZE = 4096;
+static const int DEFAULT_ITERATIONS = 1000;
+
+static QVariant parseWithQtJson(const QByteArray &data, bool &ok) {
+    return QtJson::Json::parse(QString::fromUtf8(data), ok);
+}
+
+static QVariant parseWithJsonParser(const QByteArray &data, bool &ok) {
+    JsonParser parser;
+    
+    for (int i = 0; i < data.size(); i += CHUNK_SIZE) {
+        parser.feed(data.constData() + i, qMin(CHUNK_SIZE, data.size() - i));
+    }
+    
+    ok = parser.finish();
+    return parser.result();
+}
+
+static bool benchmark(const QString &fileName, int iterations, QTextStream &out) {
+    QFile file(fileName);
+    
+    if (!file.open(QFile::ReadOnly)) {
+        out << fileName << ": " << file.errorString() << endl;
+        return false;
+    }
+    
+    const QByteArray data = file.readAll();
+    file.close();
+    
+    bool ok = false;
+    const QVariant expected = parseWithQtJson(data, ok);
+    
+    if (!ok) {
+        out << fileName << ": QtJson cannot parse file" << endl;
+        return false;
+    }
+    
+    if (parseWithJsonParser(data, ok) != expected) {
+        out << fileName << ": JsonParser result differs from QtJson" << endl;
+        return false;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    for (int i = 0; i < iterations; i++) {
+        parseWithQtJson(data, ok);
+    }
+    
+    const qint64 qtJsonTime = timer.restart();
+    
+    for (int i = 0; i < iterations; i++) {
+        parseWithJsonParser(data, ok);
+    }
+    
+    const qint64 jsonParserTime = timer.elapsed();
+    
+    out << QFileInfo(fileName).fileName() << " (" << data.size() << " bytes, " << iterations << " iterations)"
+        << endl << "    QtJson:     " << qtJsonTime << " ms" << endl << "    JsonParser: " << jsonParserTime
+        << " ms" << endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeFirst();
+    
+    int iterations = DEFAULT_ITERATIONS;
+    
+    if (!args.isEmpty()) {
+        bool ok = false;
+        const int i = args.first().toInt(&ok);
+        
+        if (ok) {
+            iterations = qMax(1, i);
+            args.removeFirst();
+        }
+    }
+    
+    if (args.isEmpty()) {
+        const QDir dir(DATA_PATH);
+        
+        foreach (const QString &fileName, dir.entryList(QStringList() << "*.json", QDir::Files, QDir::Name)) {
+            args << dir.absoluteFilePath(fileName);
+        }
+    }
+    
+    QTextStream out(stdout);
+    int failures = 0;
+    
+    foreach (const QString &fileName, args) {
+        if (!benchmark(fileName, iterations, out)) {
+            failures++;
+        }
+    }
+    
+    return failures;
+}
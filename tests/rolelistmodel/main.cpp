@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "videomodel.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+static const int DEFAULT_ROWS = 10000;
+static const int DEFAULT_PASSES = 10;
+
+class BenchmarkVideo : public CTVideo
+{
+
+public:
+    explicit BenchmarkVideo(int row, QObject *parent = 0) :
+        CTVideo(parent)
+    {
+        const QString id = QString::number(row);
+        setDate("18 Oct 2015");
+        setDescription("Description of video " + id);
+        setDuration("04:20");
+        setId(id);
+        setLargeThumbnailUrl(QUrl("http://example.com/thumbs/large/" + id + ".jpg"));
+        setService("benchmark");
+        setThumbnailUrl(QUrl("http://example.com/thumbs/" + id + ".jpg"));
+        setTitle("Video " + id);
+        setUrl(QUrl("http://example.com/videos/" + id));
+        setUserId("user" + id);
+        setUsername("User " + id);
+        setViewCount(row * 10);
+    }
+};
+
+// Reads every role of every row in order, as the delegates do while a view is scrolled
+static qint64 scrollWithRoleTable(const VideoModel &model, const QList<int> &roles, int passes) {
+    QElapsedTimer timer;
+    timer.start();
+    
+    for (int pass = 0; pass < passes; pass++) {
+        for (int row = 0; row < model.rowCount(); row++) {
+            const QModelIndex index = model.index(row);
+            
+            foreach (int role, roles) {
+                model.data(index, role);
+            }
+        }
+    }
+    
+    return timer.elapsed();
+}
+
+// The lookup the models used before RoleTable: role name to QObject property
+static qint64 scrollWithProperties(const VideoModel &model, const QList<QByteArray> &names, int passes) {
+    QElapsedTimer timer;
+    timer.start();
+    
+    for (int pass = 0; pass < passes; pass++) {
+        for (int row = 0; row < model.rowCount(); row++) {
+            const CTVideo *video = model.get(row);
+            
+            foreach (const QByteArray &name, names) {
+                video->property(name);
+            }
+        }
+    }
+    
+    return timer.elapsed();
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    
+    const int rows = (args.size() > 1 ? qMax(1, args.at(1).toInt()) : DEFAULT_ROWS);
+    const int passes = (args.size() > 2 ? qMax(1, args.at(2).toInt()) : DEFAULT_PASSES);
+    
+    VideoModel model;
+    
+    for (int i = 0; i < rows; i++) {
+        BenchmarkVideo video(i);
+        model.append(&video);
+    }
+    
+    const QHash<int, QByteArray> roleNames = model.roleNames();
+    const QList<int> roles = roleNames.keys();
+    const QList<QByteArray> names = roleNames.values();
+    
+    for (int row = 0; row < model.rowCount(); row++) {
+        foreach (int role, roles) {
+            if (model.data(model.index(row), role) != model.get(row)->property(roleNames.value(role))) {
+                QTextStream(stderr) << "Role " << roleNames.value(role) << " differs at row " << row << endl;
+                return 1;
+            }
+        }
+    }
+    
+    QTextStream out(stdout);
+    // Every model reads roles through RoleListModel, so the cost per read applies to the service models too
+    const qint64 reads = qint64(rows) * roles.size() * passes;
+    const qint64 roleTableTime = scrollWithRoleTable(model, roles, passes);
+    const qint64 propertyTime = scrollWithProperties(model, names, passes);
+    out << rows << " rows, " << roles.size() << " roles, " << passes << " passes" << endl
+        << "    RoleTable:  " << roleTableTime << " ms (" << roleTableTime * 1000000 / reads << " ns per read)" << endl
+        << "    property(): " << propertyTime << " ms (" << propertyTime * 1000000 / reads << " ns per read)" << endl;
+    return 0;
+}
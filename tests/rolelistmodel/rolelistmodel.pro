@@ -0,0 +1,20 @@
+TEMPLATE = app
+TARGET = rolelistmodel-benchmark
+
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../app/src/base
+
+HEADERS += \
+    ../../app/src/base/rolelistmodel.h \
+    ../../app/src/base/roletable.h \
+    ../../app/src/base/video.h \
+    ../../app/src/base/videomodel.h
+
+SOURCES += \
+    ../../app/src/base/rolelistmodel.cpp \
+    ../../app/src/base/video.cpp \
+    ../../app/src/base/videomodel.cpp \
+    main.cpp